@@ -0,0 +1,86 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_BATCH_ENGINE_H_
+#define _MANIFOLDS_BATCH_ENGINE_H_
+
+#include <functional>
+
+#include <manifolds/defs.h>
+#include <manifolds/ReusableTemporaryMap.h>
+
+namespace mnf
+{
+  class Manifold;
+  class PointSet;
+  class ThreadPool;
+
+  /// \brief Runs operations over all the points of a PointSet on a
+  /// ThreadPool.\n
+  /// The points are split into chunks whose size depends on the
+  /// representation size of the manifold, so that the values handled by one
+  /// chunk stay in cache, and the chunks are balanced between the threads of
+  /// the pool by work stealing. Each worker gets its own scratch buffer, that
+  /// is kept from one operation to the next.\n
+  /// The results are the same as the ones of the corresponding methods of
+  /// PointSet, and do not depend on the number of threads.
+  class MANIFOLDS_API BatchEngine
+  {
+  public:
+    /// \brief Job called on the range of points [begin, end), with the
+    /// scratch buffer of the calling worker
+    typedef std::function<void(Index begin, Index end, ReusableTemporaryMap& scratch)> Job;
+
+    /// \brief Number of doubles of the points of a chunk
+    static const Index ChunkDoubles = 2048;
+    /// \brief Minimum number of points of a chunk, so that the batch kernels
+    /// of the manifolds run on full batches
+    static const Index MinChunk = 8;
+
+    /// \brief Creates an engine running on pool. The pool must outlive the
+    /// engine.
+    explicit BatchEngine(ThreadPool& pool);
+    /// \brief Creates an engine running on ThreadPool::global()
+    BatchEngine();
+
+    /// \brief Number of threads running the operations
+    size_t threadCount() const;
+    ThreadPool& pool() const;
+
+    /// \brief Number of points of a chunk for manifold M
+    static Index chunkSize(const Manifold& M);
+
+    /// \brief Calls job on chunks of at most chunk points covering [0, n)
+    void run(Index n, Index chunk, const Job& job) const;
+
+    /// \brief Same as x.retractation(out, v)
+    void retractation(PointSet& out, const PointSet& x, const ConstRefMat& v) const;
+    /// \brief Same as x.increment(v)
+    void increment(PointSet& x, const ConstRefMat& v) const;
+    /// \brief Same as x.pseudoLog(out, y)
+    void pseudoLog(RefMat out, const PointSet& x, const PointSet& y) const;
+    /// \brief Same as x.pseudoLog0(out)
+    void pseudoLog0(RefMat out, const PointSet& x) const;
+    /// \brief Same as x.isInM(prec)
+    bool isInM(const PointSet& x, const double& prec = 1e-12) const;
+
+  private:
+    ThreadPool& pool_;
+  };
+}
+
+#endif //_MANIFOLDS_BATCH_ENGINE_H_
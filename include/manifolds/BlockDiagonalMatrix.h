@@ -0,0 +1,160 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_BLOCK_DIAGONAL_MATRIX_H_
+#define _MANIFOLDS_BLOCK_DIAGONAL_MATRIX_H_
+
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include <manifolds/defs.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  /// \brief Matrix made of dense blocks whose row ranges (and column ranges)
+  /// do not overlap, all the other coefficients being zero.\n
+  /// This is the structure of the Jacobians of a cartesian product, for which
+  /// it only stores the Jacobians of the submanifolds. Its memory and the
+  /// cost of its products are thus linear in the number of submanifolds.
+  class MANIFOLDS_API BlockDiagonalMatrix
+  {
+  public:
+    /// \brief Creates a zero matrix of size rows x cols, without blocks
+    BlockDiagonalMatrix(Index rows, Index cols);
+
+    Index rows() const;
+    Index cols() const;
+
+    /// \brief Preallocates the memory for nBlocks blocks with a total of
+    /// nCoeffs coefficients
+    void reserve(size_t nBlocks, size_t nCoeffs);
+
+    /// \brief Adds a block of size r x c whose top left corner is at
+    /// (startRow, startCol), and returns a map on it to fill it.\n
+    /// The map is only valid until the next call to addBlock.
+    Eigen::Map<Eigen::MatrixXd> addBlock(Index startRow, Index startCol, Index r, Index c);
+
+    /// \brief Adds an identity block of size n x n whose top left corner is at
+    /// (startRow, startCol). Its coefficients are not stored.
+    void addIdentityBlock(Index startRow, Index startCol, Index n);
+
+    size_t numberOfBlocks() const;
+    /// \brief Returns true if the i-th block is an identity block
+    bool isIdentityBlock(size_t i) const;
+    /// \brief Coefficients of the i-th block, that must not be an identity block
+    Eigen::Map<const Eigen::MatrixXd> block(size_t i) const;
+    Index blockRow(size_t i) const;
+    Index blockCol(size_t i) const;
+
+    /// \brief Dense version of the matrix
+    Eigen::MatrixXd toDense() const;
+    /// \brief Sparse version of the matrix
+    Eigen::SparseMatrix<double> toSparse() const;
+
+    /// \brief out = in * this
+    void applyLeft(RefMat out, const ConstRefMat& in) const;
+    /// \brief out = this * in
+    void applyRight(RefMat out, const ConstRefMat& in) const;
+    /// \brief returns in * this
+    Eigen::SparseMatrix<double> applyLeft(const Eigen::SparseMatrix<double>& in) const;
+    /// \brief returns this * in
+    Eigen::SparseMatrix<double> applyRight(const Eigen::SparseMatrix<double>& in) const;
+
+  private:
+    struct Block
+    {
+      Index row;
+      Index col;
+      Index rows;
+      Index cols;
+      size_t offset;
+      bool identity;
+    };
+
+    Index rows_;
+    Index cols_;
+    std::vector<Block> blocks_;
+    /// \brief Coefficients of the blocks, one after another in column-major order
+    std::vector<double> data_;
+  };
+
+  inline Index BlockDiagonalMatrix::rows() const
+  {
+    return rows_;
+  }
+
+  inline Index BlockDiagonalMatrix::cols() const
+  {
+    return cols_;
+  }
+
+  inline size_t BlockDiagonalMatrix::numberOfBlocks() const
+  {
+    return blocks_.size();
+  }
+
+  inline bool BlockDiagonalMatrix::isIdentityBlock(size_t i) const
+  {
+    return blocks_[i].identity;
+  }
+
+  inline Eigen::Map<const Eigen::MatrixXd> BlockDiagonalMatrix::block(size_t i) const
+  {
+    const Block& b = blocks_[i];
+    mnf_assert(!b.identity && "Identity blocks have no stored coefficients");
+    return Eigen::Map<const Eigen::MatrixXd>(data_.data() + b.offset, b.rows, b.cols);
+  }
+
+  inline Index BlockDiagonalMatrix::blockRow(size_t i) const
+  {
+    return blocks_[i].row;
+  }
+
+  inline Index BlockDiagonalMatrix::blockCol(size_t i) const
+  {
+    return blocks_[i].col;
+  }
+
+  inline Eigen::MatrixXd operator*(const Eigen::MatrixXd& M, const BlockDiagonalMatrix& B)
+  {
+    Eigen::MatrixXd out(M.rows(), B.cols());
+    B.applyLeft(out, M);
+    return out;
+  }
+
+  inline Eigen::MatrixXd operator*(const BlockDiagonalMatrix& B, const Eigen::MatrixXd& M)
+  {
+    Eigen::MatrixXd out(B.rows(), M.cols());
+    B.applyRight(out, M);
+    return out;
+  }
+
+  inline Eigen::SparseMatrix<double> operator*(const Eigen::SparseMatrix<double>& M, const BlockDiagonalMatrix& B)
+  {
+    return B.applyLeft(M);
+  }
+
+  inline Eigen::SparseMatrix<double> operator*(const BlockDiagonalMatrix& B, const Eigen::SparseMatrix<double>& M)
+  {
+    return B.applyRight(M);
+  }
+}
+
+#endif //_MANIFOLDS_BLOCK_DIAGONAL_MATRIX_H_
@@ -19,18 +19,85 @@
 #define _MANIFOLDS_CARTESIAN_POWER_H_
 
 #include <manifolds/defs.h>
-#include <manifolds/CartesianProduct.h>
+#include <manifolds/Manifold.h>
 
 namespace mnf
 {
-  /// \brief Manifold representing the cartesian product of n times the same manifold
-  class MANIFOLDS_API CartesianPower : public CartesianProduct
+  /// \brief Manifold representing the cartesian product of n times the same manifold\n
+  /// Only the factor and the number of copies are stored: the i-th copy
+  /// starts at i*M.representationDim() in the representation space and at
+  /// i*M.tangentDim() in the tangent space. The retractation hands all the
+  /// copies to the batch retractation of the factor at once.
+  class MANIFOLDS_API CartesianPower : public Manifold
   {
   public:
-    /// \brief Constructor of the \f$ M^n m2\f$
+    /// \brief Constructor of the \f$ M^n \f$
     CartesianPower(const Manifold& M, int n);
+
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+
+    virtual bool isElementary() const;
+
+    virtual bool hasIdentityJacobians() const;
+
+    virtual void display(std::string prefix = "") const;
+
+  protected:
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+
+    virtual Index startR(size_t i) const;
+    virtual Index startT(size_t i) const;
+
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const;
+    virtual void diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+    virtual long getTypeId() const;
+
+  private:
+    /// \brief The repeated manifold
+    const Manifold& manifold_;
+
+    /// \brief Number of copies of manifold_
+    Index n_;
+
+    /// \brief Dimensions of manifold_, i.e. the strides between two copies
+    Index r_;
+    Index t_;
+    Index d_;
   };
 
+  inline Index CartesianPower::startR(size_t i) const
+  {
+    mnf_assert(i < numberOfSubmanifolds() && "invalid index");
+    return static_cast<Index>(i)*r_;
+  }
+
+  inline Index CartesianPower::startT(size_t i) const
+  {
+    mnf_assert(i < numberOfSubmanifolds() && "invalid index");
+    return static_cast<Index>(i)*t_;
+  }
 }
 
 
@@ -18,11 +18,14 @@
 #ifndef _MANIFOLDS_CARTESIAN_PRODUCT_H_
 #define _MANIFOLDS_CARTESIAN_PRODUCT_H_
 
+#include <algorithm>
+#include <atomic>
 #include <vector>
 #include <stdexcept>
 #include <initializer_list>
 #include <manifolds/defs.h>
 #include <manifolds/Manifold.h>
+#include <manifolds/ThreadPool.h>
 #include <manifolds/utils.h>
 
 namespace mnf
@@ -51,10 +54,34 @@ namespace mnf
 
     virtual bool isElementary() const;
 
+    virtual bool hasIdentityJacobians() const;
+
     virtual void display(std::string prefix = "") const;
 
+    /// \brief Opt-in parallel mode: if the product has at least minLeaves
+    /// leaves (the manifolds of its flattened plan), the operations split
+    /// them across the threads of pool, or of ThreadPool::global() if pool is
+    /// null. 0, the default, disables it.\n
+    /// Each leaf is processed by the same code as in the serial mode, so the
+    /// results are identical. createRandomPoint and the block Jacobians are
+    /// always computed serially.
+    void setParallelThreshold(size_t minLeaves, ThreadPool* pool = 0x0);
+    size_t parallelThreshold() const;
+
+    /// \brief Sets the number of rows of the tiles in which applyDiffRetractation,
+    /// applyDiffPseudoLog0 and applyInvTransport process their input: all the
+    /// submanifolds are run on a tile before moving to the next one. The
+    /// temporaries of the submanifolds are then the size of a tile and stay
+    /// in cache.\n
+    /// 0, the default, disables the tiling. Since the matrices are column
+    /// major, each submanifold already reads and writes contiguous columns,
+    /// and small tiles mostly add a per-call overhead: tiles should have
+    /// several hundreds of rows.
+    void setRowTileSize(Index rows);
+    Index rowTileSize() const;
+
   protected:
-    virtual bool isInM_(const Eigen::VectorXd& val, const double& prec) const;
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
     virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
 
     virtual Index startR(size_t i) const;
@@ -62,6 +89,7 @@ namespace mnf
 
     virtual void createRandomPoint_(RefVec out, double coeff) const;
     virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
     virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
     virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
     virtual void setZero_(RefVec out) const;
@@ -69,6 +97,8 @@ namespace mnf
     virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
     virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
     virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const;
+    virtual void diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const;
     virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
     virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
 
@@ -80,9 +110,59 @@ namespace mnf
     virtual long getTypeId() const;
 
   private:
+    /// \brief In debug, checks that all the leaves of the plan still exist
+    void checkLeaves() const;
+
+    /// \brief Calls f on each entry of the plan, in parallel if the parallel
+    /// mode is on and the plan is large enough
+    template<typename F>
+    void forEachLeaf(const F& f) const;
+
+    /// \brief Calls f(start, rows) on consecutive tiles of rows covering
+    /// [0, rows)
+    template<typename F>
+    void forEachTile(Index rows, const F& f) const;
+
+    /// \brief True if forEachLeaf runs in parallel
+    bool leavesInParallel() const;
+
+    /// \brief Entry of the flattened execution plan: a manifold that is not a
+    /// CartesianProduct, with its position in the representation space, in
+    /// the tangent space and in the rows of the tangent constraint
+    struct PlanEntry
+    {
+      const Manifold* m;
+      Index startR;
+      Index startT;
+      Index startC;
+      Index dimR;
+      Index dimT;
+      Index dimC;
+    };
+
     /// \brief List of pointers on all the manifolds in the cartesian product
     std::vector<const Manifold* > submanifolds_;
 
+    /// \brief Flattened list of the non-CartesianProduct manifolds composing
+    /// this one, on which all the operations are run.\n
+    /// Nested products are expanded in the plan of their parent when they are
+    /// multiplied, which is valid because they are locked from then on. The
+    /// operations thus call the implementation of the leaves directly,
+    /// without recursion nor intermediate assertions.
+    std::vector<PlanEntry> plan_;
+
+    /// \brief True if all the submanifolds have identity Jacobians
+    bool identityJacobians_;
+
+    /// \brief Minimal number of leaves for a parallel evaluation, 0 for none
+    size_t parallelThreshold_;
+
+    /// \brief Pool used in parallel mode, ThreadPool::global() if null
+    ThreadPool* pool_;
+
+    /// \brief Number of rows of a tile, 0 for no tiling
+    Index rowTileSize_;
+
     /// \brief List of start index of submanifolds in a vector of the
     /// tangent space
     std::vector<Index> startIndexT_;
@@ -92,6 +172,52 @@ namespace mnf
     std::vector<Index> startIndexR_;
   };
 
+  inline void CartesianProduct::checkLeaves() const
+  {
+#ifndef NDEBUG
+    for (const auto& e : plan_)
+      mnf_assert(e.m->isValid() || e.m->seeMessageAbove());
+#endif
+  }
+
+  inline bool CartesianProduct::leavesInParallel() const
+  {
+    return parallelThreshold_ > 0 && plan_.size() >= parallelThreshold_;
+  }
+
+  template<typename F>
+  inline void CartesianProduct::forEachLeaf(const F& f) const
+  {
+    if (!leavesInParallel())
+    {
+      for (const auto& e : plan_)
+        f(e);
+      return;
+    }
+    ThreadPool& pool = pool_ ? *pool_ : ThreadPool::global();
+    Index n = static_cast<Index>(plan_.size());
+    Index grain = std::max<Index>(1, n / static_cast<Index>(4 * pool.size()));
+    pool.parallelFor(0, n, grain, [this, &f](Index b, Index e)
+    {
+      for (Index i = b; i < e; ++i)
+        f(plan_[static_cast<size_t>(i)]);
+    });
+  }
+
+  template<typename F>
+  inline void CartesianProduct::forEachTile(Index rows, const F& f) const
+  {
+    //In parallel mode, each thread works on its own columns, tiling the rows
+    //would only add synchronizations
+    if (rowTileSize_ == 0 || rows <= rowTileSize_ || plan_.size() < 2 || leavesInParallel())
+    {
+      f(0, rows);
+      return;
+    }
+    for (Index start = 0; start < rows; start += rowTileSize_)
+      f(start, std::min(rowTileSize_, rows - start));
+  }
+
   inline Index CartesianProduct::startR(size_t i) const
   {
     mnf_assert(i < numberOfSubmanifolds() && "invalid index");
@@ -38,16 +38,35 @@ namespace mnf
     static const int InputDim_ = 3;
     typedef Eigen::Matrix3d DisplayType;
     typedef Eigen::Matrix3d OutputType;
-    static bool isInM_(const Eigen::VectorXd& val, const double& prec);
+    static bool isInM_(const ConstRefVec& val, const double& prec);
     static void forceOnM_(RefVec out, const ConstRefVec& in);
     static void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v);
+    static void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v);
+    static void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v);
     static void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y);
     static void pseudoLog0_(RefVec out, const ConstRefVec& x);
     static void setZero_(RefVec out);
+    /// \brief Rotation matrix represented by x
+    static Eigen::Matrix3d rotationMatrix(const ConstRefVec& x);
 
     static void logarithm(RefVec out, const OutputType& M);
     static void exponential(OutputType& out, const ConstRefVec& v);
 
+    /// \brief Computes the exponential of each column of v (3xN) into the
+    /// corresponding column of out (9xN).
+    /// Each column of v must be of norm at most pi.
+    static void batchExponential(RefMat out, const ConstRefMat& v);
+    /// \brief Computes the logarithm of each column of R (9xN) into the
+    /// corresponding column of out (3xN).
+    static void batchLogarithm(RefMat out, const ConstRefMat& R);
+    /// \brief Structure-of-arrays version of batchExponential: v is Nx3 and
+    /// out is Nx9. Each column is the plane of one coefficient for the N
+    /// rotations, the coefficients of the matrices being in column-major order.
+    static void batchExponentialSoA(RefMat out, const ConstRefMat& v);
+    /// \brief Structure-of-arrays version of batchLogarithm: R is Nx9 and
+    /// out is Nx3.
+    static void batchLogarithmSoA(RefMat out, const ConstRefMat& R);
+
     static Eigen::Matrix<double, 9, 3> diffRetractation_(const ConstRefVec& x);
     static void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, ReusableTemporaryMap& m);
     static Eigen::Matrix<double, 3, 9> diffPseudoLog0_(const ConstRefVec& x);
@@ -18,17 +18,23 @@
 #ifndef _MANIFOLDS_MANIFOLD_H_
 #define _MANIFOLDS_MANIFOLD_H_
 
+#include <atomic>
 #include <iostream>
 #include <Eigen/Core>
 #include <manifolds/defs.h>
 #include <manifolds/view.h>
+#include <manifolds/BlockDiagonalMatrix.h>
 #include <manifolds/RefCounter.h>
 #include <manifolds/Point.h>
+#include <manifolds/PointArena.h>
 #include <manifolds/ValidManifold.h>
 
 
 namespace mnf
 {
+  template<typename... M> class StaticCartesianProduct;
+  class ThreadPool;
+
   /// \brief The Manifold Class represents a manifold. It contains the implementations of
   /// the basic operations on it, like external addition, internal substraction,
   /// Translation from tangent space to representation space and back, derivatives
@@ -50,6 +56,11 @@ namespace mnf
     /// representation space
     Manifold(Index dimension, Index tangentDimension, Index representationDimension);
 
+    /// \brief Copy constructor. The copy has the same identity and lock
+    /// status as other, but no point depends on it yet.
+    Manifold(const Manifold& other);
+    Manifold& operator=(const Manifold& other);
+
     /// \brief The destructor
     virtual ~Manifold();
 
@@ -69,9 +80,17 @@ namespace mnf
     Point createRandomPoint(double coeff = 1.0) const;
     void createRandomPoint(RefVec out, double coeff = 1.0) const;
 
+    /// \brief Versions of createPoint, getZero and createRandomPoint where the
+    /// value of the point is stored in the memory of arena instead of being
+    /// allocated on the heap
+    Point createPoint(PointArena& arena) const;
+    Point createPoint(const ConstRefVec& val, PointArena& arena) const;
+    Point getZero(PointArena& arena) const;
+    Point createRandomPoint(PointArena& arena, double coeff = 1.0) const;
+
     /// \brief Checks that the value val described in the representation space
     /// is an element of the manifold
-    virtual bool isInM(const Eigen::VectorXd& val, const double& prec = 1e-12) const;
+    virtual bool isInM(const ConstRefVec& val, const double& prec = 1e-12) const;
 
     /// \brief finds the closest point to \a in on \f$ \mathbb{M} \f$.
     virtual void forceOnM(RefVec out, const ConstRefVec& in) const;
@@ -131,6 +150,20 @@ namespace mnf
     /// \f$v\in T_x^\mathcal{M}\f$
     void retractation(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
 
+    /// \brief Batch version of retractation: applies the external addition
+    /// on N points at once, \f$ out_j = x_j \oplus v_j \f$ for each column j.
+    /// The checks are performed once for the whole batch.
+    /// \param out output matrix, each column is an element of the manifold
+    /// \param x matrix whose columns are elements of the manifold
+    /// \param v matrix whose columns are elements of the tangent space at the
+    /// corresponding column of x
+    void batchRetractation(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+
+    /// \brief Structure-of-arrays version of batchRetractation: row j of x
+    /// (N x r) and of v (N x t) are the j-th point and tangent vector, so that
+    /// each coefficient has its own contiguous plane. out is N x r.
+    void batchRetractationSoA(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+
     /// \brief PseudoLog operation
     /// \f$ out = {Log}_x(y) \f$
     /// \param out output reference on element of the tangent space of the
@@ -160,6 +193,16 @@ namespace mnf
     /// \param x point of the manifold on which the map is taken
     void applyDiffRetractation(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
 
+    /// \brief Returns true if, at any point, diffRetractation and
+    /// diffPseudoLog0 are identity matrices, and thus the corresponding apply
+    /// methods copy their input. Callers can then skip forming these Jacobians
+    /// or multiplying by them.
+    virtual bool hasIdentityJacobians() const;
+
+    /// \brief Same as diffRetractation, but only the blocks corresponding to
+    /// the submanifolds are stored
+    BlockDiagonalMatrix diffRetractationBlocks(const ConstRefVec& x) const;
+
     /// \brief Computes the Jacobian matrix of the pseudoLog0 function
     /// \f$\frac{\partial\phi^{-1}_0}{\partial x}(x)\f$
     /// \param x element of manifold \f$x\in\mathbb{M}\f$
@@ -173,6 +216,18 @@ namespace mnf
     /// \param x point of the manifold on which the map is taken
     void applyDiffPseudoLog0(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
 
+    /// \brief Opt-in parallel mode for applyDiffRetractation and
+    /// applyDiffPseudoLog0: when in has at least minRows rows, it is split
+    /// into tiles of rows, processed by the threads of pool, or of
+    /// ThreadPool::global() if pool is null. Each thread works in its own
+    /// temporary buffer. 0, the default, disables it.
+    void setRowParallelThreshold(Index minRows, ThreadPool* pool = 0x0);
+    Index rowParallelThreshold() const;
+
+    /// \brief Same as diffPseudoLog0, but only the blocks corresponding to
+    /// the submanifolds are stored
+    BlockDiagonalMatrix diffPseudoLog0Blocks(const ConstRefVec& x) const;
+
     /// \brief applies a transport operation from point \f$x\in\mathcal{M}\f$ of
     /// direction \f$v\in T_x^\mathcal{M}\f$ on matrix in
     /// \param out result of the operation
@@ -242,7 +297,7 @@ namespace mnf
     void setRepresentationDimension(Index rd);
 
     /// \brief Ensures that val in representation space in a point of M
-    virtual bool isInM_(const Eigen::VectorXd& val, const double& prec) const = 0;
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const = 0;
 
     /// \brief finds the closest point to \a in on \f$ \mathbb{M} \f$.
     virtual void forceOnM_(RefVec out, const ConstRefVec& in) const = 0;
@@ -272,6 +327,11 @@ namespace mnf
 
     virtual void createRandomPoint_(RefVec out, double coeff) const = 0;
     virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const = 0;
+    /// \brief Default implementation loops on retractation_ for each column
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    /// \brief Default implementation copies each point and tangent vector in
+    /// a temporary vector and calls retractation_.
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
     virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const = 0;
     virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const = 0;
     virtual void setZero_(RefVec out) const = 0;
@@ -279,6 +339,14 @@ namespace mnf
     virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const = 0;
     virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const = 0;
     virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const = 0;
+    /// \brief Adds the blocks of diffRetractation(x) to J, shifted by
+    /// (startR, startT). The default implementation adds diffRetractation_(x)
+    /// as a single block, or an identity block if hasIdentityJacobians().
+    virtual void diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const;
+    /// \brief Adds the blocks of diffPseudoLog0(x) to J, shifted by
+    /// (startT, startR). The default implementation adds diffPseudoLog0_(x)
+    /// as a single block, or an identity block if hasIdentityJacobians().
+    virtual void diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const;
     virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const = 0;
     virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const = 0;
 
@@ -293,6 +361,16 @@ namespace mnf
     void testLock() const;
 
   private:
+    /// \brief Calls f(start, rows) on tiles of rows covering [0, rows), in
+    /// parallel if the row-parallel mode is on and there are enough rows
+    template<typename F>
+    void forEachRowTile(Index rows, const F& f) const;
+
+    //CartesianProduct and CartesianPower run the operations of their
+    //submanifolds directly
+    friend class CartesianProduct;
+    friend class CartesianPower;
+
     /// \brief Name of the Manifold
     std::string name_;
 
@@ -305,15 +383,22 @@ namespace mnf
     /// \brief dimension of the representation space of the manifold
     Index representationDim_;
 
-    /// \brief a static counter used to generate the instanceId value
-    /// TODO: currently not used in a thread-safe way!
-    static long manifoldCounter_;
+    /// \brief a static counter used to generate the instanceId value.\n
+    /// It is atomic so that manifolds can be built from several threads.
+    static std::atomic<long> manifoldCounter_;
 
     /// \brief a value used to identify different instances at runtime
     long instanceId_;
 
     /// \brief if true, the manifold if locked
-    mutable bool lock_;
+    mutable std::atomic<bool> lock_;
+
+    /// \brief Minimal number of rows for a row-parallel evaluation, 0 for none
+    Index rowParallelThreshold_;
+
+    /// \brief Pool used for the row-parallel evaluation, ThreadPool::global()
+    /// if null
+    ThreadPool* rowPool_;
 
   };
 
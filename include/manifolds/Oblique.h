@@ -0,0 +1,96 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_OBLIQUE_H_
+#define _MANIFOLDS_OBLIQUE_H_
+
+#include <manifolds/defs.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/utils.h>
+
+namespace mnf
+{
+  /// \brief Manifold of the k x n matrices whose columns are unit vectors,
+  /// also known as the oblique manifold OB(k, n). It is the cartesian power
+  /// of n spheres \f$ S^{k-1} \f$.\n
+  /// A point is represented by its matrix in column-major order, and a
+  /// tangent vector by a k x n matrix whose columns are orthogonal to the
+  /// corresponding columns of the point. The operations are those of Sn,
+  /// applied column-wise on the whole matrix in a single pass, instead of
+  /// calling each sphere of a CartesianPower.
+  class MANIFOLDS_API Oblique : public Manifold
+  {
+  public:
+    /// \brief Constructor
+    /// \param k dimension of the vectors
+    /// \param n number of vectors
+    Oblique(Index k, Index n);
+    Oblique(Index k, Index n, double magnitude);
+
+    /// \brief Dimension k of the vectors
+    Index vectorDim() const;
+    /// \brief Number n of vectors
+    Index numberOfVectors() const;
+
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+    void setTypicalMagnitude(double magnitude);
+    void setTypicalMagnitude(const ConstRefVec& out);
+    virtual bool isElementary() const;
+    virtual long getTypeId() const;
+
+  protected:
+    //map operations
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+
+  private:
+    typedef Eigen::Map<Eigen::MatrixXd> MatMap;
+    typedef Eigen::Map<const Eigen::MatrixXd> ConstMatMap;
+
+    /// \brief View of a point or tangent vector as a k x n matrix
+    MatMap mat(RefVec v) const;
+    ConstMatMap mat(const ConstRefVec& v) const;
+
+    Index k_;
+    Index n_;
+    Eigen::VectorXd typicalMagnitude_;
+  };
+}
+#endif //_MANIFOLDS_OBLIQUE_H_
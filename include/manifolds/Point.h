@@ -23,6 +23,7 @@
 namespace mnf
 {
   class Manifold;
+  class PointArena;
 
   class MANIFOLDS_API ConstSubPoint
   {
@@ -66,6 +67,7 @@ namespace mnf
 
     friend inline std::ostream& operator<< (std::ostream& os, const ConstSubPoint& x);
     friend class RefCounter;
+    friend class PointSet;
   };
 
   class MANIFOLDS_API SubPoint : public ConstSubPoint
@@ -94,38 +96,79 @@ namespace mnf
     Segment operator[](size_t i);
     ConstSegment operator[](size_t i) const { return ConstSubPoint::operator[](i); }
 
+    friend class PointSet;
   };
 
 
+  /// \brief Storage of the value of a Point, either owned by the point or
+  /// taken from a PointArena.\n
+  /// Values of size at most InlineSize are stored inside the object itself,
+  /// larger ones are allocated on the heap.
   class MANIFOLDS_API PointMemory
   {
+  public:
+    static const Index InlineSize = 16;
+
   protected:
-    PointMemory(Index size);
-    PointMemory(const ConstRefVec& v);
-    Eigen::VectorXd& getMem();
+    PointMemory(Index size, PointArena* arena = 0x0);
+    PointMemory(const ConstRefVec& v, PointArena* arena = 0x0);
+    /// \brief Takes over the heap buffer or the arena memory of other.
+    /// Inline values are copied. If the memory was taken, other is left
+    /// empty (but keeps its arena).
+    PointMemory(PointMemory&& other);
+    ~PointMemory();
+    RefVec getMem();
+    PointArena* getArena() const;
+    /// \brief Swaps the heap buffers of this and other if both are on the heap
+    /// (or empty) and other is not empty. Returns false if nothing was done.
+    bool swapMem(PointMemory& other);
+    /// \brief Allocates a memory of given size if this is empty, from the
+    /// arena if there is one.
+    void ensureMem(Index size);
 
   private:
+    PointMemory(const PointMemory&);
+    PointMemory& operator=(const PointMemory&);
+
+    EIGEN_ALIGN16 double inline_[InlineSize];
     Eigen::VectorXd mem_;
+    PointArena* arena_;
+    double* data_;
+    Index size_;
   };
 
 
   class MANIFOLDS_API Point : public PointMemory, public SubPoint
   {
   private:  //only Manifold can create Point
-    Point(const Manifold& M);
-    Point(const Manifold& M, const ConstRefVec& val);
+    Point(const Manifold& M, PointArena* arena = 0x0);
+    Point(const Manifold& M, const ConstRefVec& val, PointArena* arena = 0x0);
 
   public:
+    /// \brief Copy constructor. The copy takes its memory from the same arena
+    /// as other, if any.
     Point(const Point& other);
+    /// \brief Move constructor. Takes over the memory of other when it is on
+    /// the heap or in an arena, copies the value otherwise.\n
+    /// A moved-from Point can only be destroyed or assigned to.
+    Point(Point&& other);
     Point(const ConstSubPoint& other);
 
     /// \internal For now, we keep operations on Point only. ConstSubPoint and SubPoint
     /// are only intended for memory read/write, not Manifold operations. 
-    Point& increment(const ConstRefVec& v);
+    Point& increment(const ConstRefVec& v) &;
+    /// \brief Same as increment on an lvalue, but returns the point as an
+    /// rvalue so that its memory can be taken over, e.g. in
+    /// Point y = std::move(x).increment(v);
+    Point&& increment(const ConstRefVec& v) &&;
     Point& operator=(const Point& x);
+    /// \brief Move assignment. Swaps the memories of the two points when
+    /// possible, copies the value otherwise.
+    Point& operator=(Point&& x);
 
     /// \brief Computes a new point that is the result of a retractation of v 
-    /// at the current point x. \f$ out = \phi_x(v) \f$
+    /// at the current point x. \f$ out = \phi_x(v) \f$\n
+    /// The new point takes its memory from the same arena as this one, if any.
     Point retractation(const ConstRefVec& v) const;
     /// \brief Fills vector out with the value of a point that is the result of a retractation of v 
     /// at the current point x. \f$ out = \phi_x(v) \f$
@@ -178,10 +221,17 @@ namespace mnf
     /// \brief Proxy for Manifold::applyInvTransport at current Point
     void applyInvTransport(RefMat out, const ConstRefMat& in, const ConstRefVec& v) const;
 
+  private:
+    /// \brief Makes value_ refer to the current memory
+    void reseat();
+
     friend class Manifold;
   };
 
   MANIFOLDS_API Point operator+(const Point& x, const ConstRefVec& v);
+  /// \brief Increments x in place and returns it, so that chained expressions
+  /// such as x + v1 + v2 do not copy the value.
+  MANIFOLDS_API Point operator+(Point&& x, const ConstRefVec& v);
   MANIFOLDS_API Eigen::VectorXd operator-(const Point& x, const Point& y);
 
   inline std::ostream& operator<< (std::ostream& os, const ConstSubPoint& x)
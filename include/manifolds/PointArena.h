@@ -0,0 +1,97 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_POINT_ARENA_H_
+#define _MANIFOLDS_POINT_ARENA_H_
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <manifolds/defs.h>
+#include <manifolds/RefCounter.h>
+
+namespace mnf
+{
+  /// \brief Memory pool from which Points can take the storage of their value.\n
+  /// Memory is taken from large chunks by moving a cursor, and is only given
+  /// back all at once, by clear() or upon destruction. This avoids one heap
+  /// allocation per Point when many points are created and discarded
+  /// together.\n
+  /// All the points using the arena must be destroyed before it is cleared or
+  /// destroyed.
+  class MANIFOLDS_API PointArena
+  {
+  public:
+    /// \brief Constructor
+    /// \param chunkSize number of doubles in each chunk of memory
+    PointArena(size_t chunkSize = 4096);
+    ~PointArena() NOEXCEPT(false);
+
+    /// \brief Returns a pointer on n consecutive doubles
+    double* allocate(Index n);
+
+    /// \brief Makes all the memory of the arena available again. The chunks
+    /// already allocated are kept for reuse.
+    void clear();
+
+    /// \brief Frees all the memory of the arena
+    void release();
+
+    /// \brief Number of doubles currently handed out, including padding
+    size_t used() const;
+
+    /// \brief Number of doubles allocated by the arena
+    size_t capacity() const;
+
+  private:
+    PointArena(const PointArena&);
+    PointArena& operator=(const PointArena&);
+
+    void registerPoint();
+    void unregisterPoint();
+    void testEmpty() const;
+
+    struct Chunk
+    {
+      double* data;
+      size_t size;
+    };
+
+    Eigen::aligned_allocator<double> allocator_;
+    size_t chunkSize_;
+    std::vector<Chunk> chunks_;
+    /// \brief Index of the chunk in which the next allocation is attempted
+    size_t current_;
+    /// \brief Number of doubles used in the current chunk
+    size_t offset_;
+    /// \brief Number of doubles used in the previous chunks
+    size_t usedBefore_;
+#ifndef NDEBUG
+    int count_;
+#endif
+
+    friend class PointMemory;
+  };
+
+  inline size_t PointArena::used() const
+  {
+    return usedBefore_ + offset_;
+  }
+}
+
+#endif //_MANIFOLDS_POINT_ARENA_H_
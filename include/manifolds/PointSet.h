@@ -0,0 +1,152 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_POINT_SET_H_
+#define _MANIFOLDS_POINT_SET_H_
+
+#include <Eigen/Core>
+
+#include <manifolds/defs.h>
+#include <manifolds/Point.h>
+
+namespace mnf
+{
+  class Manifold;
+
+  /// \brief Container of points of a same manifold, whose values are stored
+  /// in a single contiguous and aligned buffer.\n
+  /// The value of the i-th point is the i-th column of a matrix with
+  /// representationDim() rows, so that operations on the whole set are done
+  /// with the batch methods of the manifold. The set is registered only once
+  /// to the manifold, whatever its size.\n
+  /// The views returned by operator[] are invalidated when the buffer is
+  /// reallocated by reserve, resize or push_back.\n
+  /// Alternatively, the values can be stored in a structure-of-arrays layout,
+  /// where the i-th point is the i-th row of the matrix: each coefficient has
+  /// its own contiguous plane, which lets the batch kernels of the elementary
+  /// manifolds use full SIMD registers. In this layout, the points are not
+  /// contiguous and can only be accessed by copy, with getPoint.
+  class MANIFOLDS_API PointSet
+  {
+  public:
+    enum Layout
+    {
+      ArrayOfStructures,  ///< each point is a column of values()
+      StructureOfArrays   ///< each point is a row of values()
+    };
+
+    /// \brief Iterator on the points of a set. Dereferencing returns a view
+    /// on the current point.
+    template<typename SubPointType, typename SetType>
+    class Iterator
+    {
+    public:
+      Iterator(SetType* set, Index i) : set_(set), i_(i) {}
+      SubPointType operator*() const { return (*set_)[i_]; }
+      Iterator& operator++() { ++i_; return *this; }
+      bool operator==(const Iterator& other) const { return i_ == other.i_ && set_ == other.set_; }
+      bool operator!=(const Iterator& other) const { return !(*this == other); }
+      Index index() const { return i_; }
+
+    private:
+      SetType* set_;
+      Index i_;
+    };
+
+    typedef Iterator<SubPoint, PointSet> iterator;
+    typedef Iterator<ConstSubPoint, const PointSet> const_iterator;
+
+    /// \brief Creates a set of n points of M, all set to zero.
+    PointSet(const Manifold& M, Index n = 0, Layout layout = ArrayOfStructures);
+    PointSet(const PointSet& other);
+    ~PointSet();
+
+    /// \brief Copies the values and the layout of other. Both sets must be
+    /// on the same manifold.
+    PointSet& operator=(const PointSet& other);
+
+    Layout layout() const;
+    /// \brief Converts the storage of the set to the given layout
+    void setLayout(Layout layout);
+
+    /// \brief Number of points in the set
+    Index size() const;
+    /// \brief Number of points the set can hold without reallocating
+    Index capacity() const;
+    bool empty() const;
+
+    /// \brief Changes the number of points. New points are set to zero.
+    void resize(Index n);
+    /// \brief Makes sure that the set can hold n points without reallocating
+    void reserve(Index n);
+    /// \brief Removes all the points. The memory is kept.
+    void clear();
+    /// \brief Appends a point of value val at the end of the set
+    void push_back(const ConstRefVec& val);
+
+    /// \brief View on the i-th point. Only for the ArrayOfStructures layout.
+    SubPoint operator[](Index i);
+    ConstSubPoint operator[](Index i) const;
+
+    /// \brief Copy of the i-th point, for any layout
+    Point getPoint(Index i) const;
+
+    /// \brief Matrix whose columns (ArrayOfStructures) or rows
+    /// (StructureOfArrays) are the values of the points
+    RefMat values();
+    ConstRefMat values() const;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    const Manifold& getManifold() const;
+
+    //The tangent vectors given to or returned by the following methods are
+    //stored with the same layout as the points: one per column of a t x N
+    //matrix for ArrayOfStructures, one per row of a N x t matrix for
+    //StructureOfArrays.
+
+    /// \brief Retractation of each point by the corresponding tangent vector
+    /// of v, in place: \f$ x_j = \phi_{x_j}(v_j) \f$
+    PointSet& increment(const ConstRefMat& v);
+    /// \brief Fills out with the retractation of each point by the
+    /// corresponding tangent vector of v: \f$ out_j = \phi_{x_j}(v_j) \f$.\n
+    /// out must have the same layout as this set.
+    void retractation(PointSet& out, const ConstRefMat& v) const;
+    /// \brief Fills out with the pseudoLog of each point of y at the
+    /// corresponding point of this set: \f$ out_j = Log_{x_j}(y_j) \f$
+    void pseudoLog(RefMat out, const PointSet& y) const;
+    /// \brief Fills out with the pseudoLog0 of each point
+    void pseudoLog0(RefMat out) const;
+    /// \brief Checks that all the points of the set belong to the manifold
+    bool isInM(const double& prec = 1e-12) const;
+
+  private:
+    bool isAoS() const;
+
+    const Manifold& manifold_;
+    Layout layout_;
+    /// \brief Buffer of the values, with capacity() columns (ArrayOfStructures)
+    /// or rows (StructureOfArrays)
+    Eigen::MatrixXd mem_;
+    Index size_;
+  };
+}
+
+#endif //_MANIFOLDS_POINT_SET_H_
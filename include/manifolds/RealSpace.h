@@ -21,6 +21,7 @@
 #include <iostream>
 #include <manifolds/defs.h>
 #include <manifolds/Manifold.h>
+#include <manifolds/StaticDims.h>
 #include <manifolds/utils.h>
 
 namespace mnf
@@ -44,14 +45,17 @@ namespace mnf
     void setTypicalMagnitude(double magnitude);
     void setTypicalMagnitude(const ConstRefVec& out);
     virtual bool isElementary() const;
+    virtual bool hasIdentityJacobians() const;
     virtual long getTypeId() const;
 
   protected:
     //map operations
-    virtual bool isInM_(const Eigen::VectorXd& , const double& prec) const;
+    virtual bool isInM_(const ConstRefVec& , const double& prec) const;
     virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
     virtual void createRandomPoint_(RefVec out, double coeff) const;
     virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
     virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
     virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
     virtual void setZero_(RefVec out) const;
@@ -67,10 +71,28 @@ namespace mnf
     virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec&x) const;
     virtual void limitMap_(RefVec out) const;
 
+    template<typename... M> friend class StaticCartesianProduct;
+
   private:
     Eigen::VectorXd typicalMagnitude_;
 
   };
+
+  /// \brief RealSpace whose dimension is known at compile time, to be used
+  /// in a StaticCartesianProduct
+  template<int N>
+  class RealSpaceN : public RealSpace
+  {
+  public:
+    RealSpaceN() : RealSpace(N) {}
+    RealSpaceN(double magnitude) : RealSpace(N, magnitude) {}
+    RealSpaceN(const ConstRefVec& magnitude) : RealSpace(N, magnitude) {}
+  };
+
+  template<int N> struct StaticDims<RealSpaceN<N> >
+  {
+    enum { Dim = N, TangentDim = N, RepresentationDim = N };
+  };
 }
 
 #endif //_MANIFOLDS_REAL_SPACE_H_
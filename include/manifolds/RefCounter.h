@@ -18,6 +18,8 @@
 #ifndef _MANIFOLDS_REF_COUNTER_H_
 #define _MANIFOLDS_REF_COUNTER_H_
 
+#include <atomic>
+
 #include <manifolds/defs.h>
 #include <manifolds/Point.h>
 #include <manifolds/mnf_assert.h>
@@ -32,7 +34,9 @@
 namespace mnf
 {
   /// \brief object containing a counter and that cannot be destroyed if the
-  /// counter is not at 0.
+  /// counter is not at 0.\n
+  /// The counter is atomic, so that points can be created and destroyed from
+  /// several threads. Incrementing it is a single relaxed atomic addition.
   class RefCounter
   {
     public:
@@ -43,11 +47,25 @@ namespace mnf
       {
       }
 
+      /// \brief No point depends on a copy upon its creation
+      RefCounter(const RefCounter&)
+#ifndef NDEBUG
+        :count_(0)
+#endif
+      {
+      }
+
+      /// \brief The counter is not copied
+      RefCounter& operator=(const RefCounter&)
+      {
+        return *this;
+      }
+
       // In C++ 11, by default, a destructor cannot launch an exception, setting noexcet to false allows it.
       ~RefCounter() NOEXCEPT(false)
       {
 #ifndef NDEBUG
-        mnf_assert(count_ == 0 && "You cannot destroy this manifold because some points still depend on it");
+        mnf_assert(count_.load(std::memory_order_acquire) == 0 && "You cannot destroy this manifold because some points still depend on it");
 #endif
       }
 
@@ -55,23 +73,24 @@ namespace mnf
       void incrementRefCounter() const
       {
 #ifndef NDEBUG
-        count_++;
+        count_.fetch_add(1, std::memory_order_relaxed);
 #endif
       }
       void decrementRefCounter() const
       {
 #ifndef NDEBUG
-        mnf_assert(count_>0 && "You cannot decrement when no point exist");
-        count_--;
+        int previous = count_.fetch_sub(1, std::memory_order_acq_rel);
+        mnf_assert(previous>0 && "You cannot decrement when no point exist");
 #endif
       }
 
     private:
 #ifndef NDEBUG
-      mutable int count_;
+      mutable std::atomic<int> count_;
 #endif
       friend void ConstSubPoint::registerPoint();
       friend void ConstSubPoint::unregisterPoint();
+      friend class PointSet;
   };
 }
 
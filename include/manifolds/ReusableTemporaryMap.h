@@ -35,6 +35,12 @@ namespace mnf
 
     Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> getMap(Eigen::DenseIndex m, Eigen::DenseIndex n);
 
+    /// \brief Buffer owned by the calling thread.\n
+    /// It is shared by all the manifolds used in this thread, so that a
+    /// manifold can be used concurrently by several threads. The map it returns
+    /// must not be kept after the operation that requested it.
+    static ReusableTemporaryMap& threadBuffer();
+
   private:
     ReusableTemporaryMap& operator= (const ReusableTemporaryMap&); //We forbid copy
 
@@ -21,6 +21,7 @@
 
 #include <manifolds/defs.h>
 #include <manifolds/Manifold.h>
+#include <manifolds/StaticDims.h>
 #include <manifolds/utils.h>
 
 namespace mnf
@@ -60,9 +61,11 @@ namespace mnf
 
   protected:
     //map operations
-    virtual bool isInM_(const Eigen::VectorXd& val, const double& prec) const;
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
     virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
     virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
     virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
     virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
     virtual void setZero_(RefVec out) const;
@@ -78,8 +81,15 @@ namespace mnf
     virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
     virtual void limitMap_(RefVec out) const;
 
+    template<typename... M> friend class StaticCartesianProduct;
+
   private:
     Eigen::Vector3d typicalMagnitude_;
   };
+
+  template<> struct StaticDims<S2>
+  {
+    enum { Dim = 2, TangentDim = 3, RepresentationDim = 3 };
+  };
 }
 #endif //_MANIFOLDS_S2_H_
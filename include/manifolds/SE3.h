@@ -0,0 +1,391 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_SE3_H_
+#define _MANIFOLDS_SE3_H_
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <limits>
+#include <sstream>
+
+#include <manifolds/defs.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/ReusableTemporaryMap.h>
+#include <manifolds/StaticDims.h>
+#include <manifolds/utils.h>
+
+namespace mnf
+{
+  /// \brief Closed-form quantities of the exponential map of SE(3) that do
+  /// not depend on the representation of the rotations.\n
+  /// For a twist (nu, w), exp(nu, w) = (exp(w), V(w) nu), with
+  /// \f$ V(w) = I + B [w]_\times + C [w]_\times^2 \f$,
+  /// \f$ B = (1-\cos\theta)/\theta^2 \f$, \f$ C = (\theta-\sin\theta)/\theta^3 \f$
+  /// and \f$ \theta = \|w\| \f$.
+  struct MANIFOLDS_API SE3Algebra
+  {
+    /// \brief Below this squared angle, the coefficients are computed with
+    /// their Taylor expansions
+    static const double prec;
+
+    /// \brief Matrix of the cross product by w
+    static Eigen::Matrix3d hat(const Eigen::Vector3d& w);
+    /// \brief V(w)
+    static Eigen::Matrix3d leftJacobian(const Eigen::Vector3d& w);
+    /// \brief \f$ V(w)^{-1} = I - \frac{1}{2}[w]_\times + D [w]_\times^2 \f$,
+    /// with \f$ D = 1/\theta^2 - \cot(\theta/2)/(2\theta) \f$.
+    /// w must be of norm at most pi.
+    static Eigen::Matrix3d invLeftJacobian(const Eigen::Vector3d& w);
+    /// \brief Derivative of \f$ V(w)^{-1} t \f$ with respect to w
+    static Eigen::Matrix3d diffInvLeftJacobian(const Eigen::Vector3d& w, const Eigen::Vector3d& t);
+  };
+
+  /// \brief Manifold representing the space of rigid-body transformations,
+  /// also known as SE(3). It is templated by the map of its rotation part.\n
+  /// A point is represented by its translation followed by its rotation, in
+  /// the representation of Map (7 doubles with ExpMapQuaternion, 12 with
+  /// ExpMapMatrix). A tangent vector is a twist (nu, w), nu being the linear
+  /// part, expressed in the local frame, and w the angular one.\n
+  /// The retractation is the exact exponential map of SE(3), x+(nu, w) =
+  /// x*exp(nu, w): compared to the product of RealSpace(3) and SO3<Map>, the
+  /// translation increment is rotated and coupled to the rotation increment.
+  template<typename Map>
+  class SE3: public Manifold
+  {
+  public:
+    /// \brief Size of the representation of a point
+    static const int RepDim_ = 3 + Map::OutputDim_;
+
+    SE3();
+    SE3(double translationMagnitude, double rotationMagnitude);
+    SE3(const ConstRefVec& magnitude);
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+    void setTypicalMagnitude(double translationMagnitude, double rotationMagnitude);
+    void setTypicalMagnitude(const ConstRefVec& out);
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+    virtual bool isElementary() const;
+    virtual long getTypeId() const;
+
+  protected:
+    //map operations
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+
+    template<typename... M> friend class StaticCartesianProduct;
+
+  private:
+    typedef Eigen::Matrix<double, RepDim_, 1> RepVector;
+    typedef Eigen::Matrix<double, 6, 1> TwistVector;
+
+    /// \brief Translation of x + (nu, w), for a point x of rotation matrix R
+    static Eigen::Vector3d translationIncrement(const Eigen::Matrix3d& R, const Eigen::Vector3d& nu, const Eigen::Vector3d& w);
+
+    Eigen::Matrix<double, 6, 1> typicalMagnitude_;
+  };
+
+  //Implementations of the methods
+  template<typename Map>
+  const int SE3<Map>::RepDim_;
+
+  template<typename Map>
+  inline SE3<Map>::SE3()
+    : Manifold(6, 6, RepDim_)
+  {
+    name() = "SE3";
+    setTypicalMagnitude(1, M_PI);
+    //allocates the buffer of this thread now rather than at the first use
+    ReusableTemporaryMap::threadBuffer();
+  }
+
+  template<typename Map>
+  inline SE3<Map>::SE3(double translationMagnitude, double rotationMagnitude)
+    : Manifold(6, 6, RepDim_)
+  {
+    name() = "SE3";
+    setTypicalMagnitude(translationMagnitude, rotationMagnitude);
+    ReusableTemporaryMap::threadBuffer();
+  }
+
+  template<typename Map>
+  inline SE3<Map>::SE3(const ConstRefVec& magnitude)
+    : Manifold(6, 6, RepDim_)
+  {
+    mnf_assert(magnitude.size() == 6 && "magnitude on SE3 must be of size 6");
+    name() = "SE3";
+    setTypicalMagnitude(magnitude);
+    ReusableTemporaryMap::threadBuffer();
+  }
+
+  template<typename Map>
+  inline bool SE3<Map>::isInM_(const ConstRefVec& val, const double& prec) const
+  {
+    return Map::isInM_(val.tail<Map::OutputDim_>(), prec);
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    out.head<3>() = in.head<3>();
+    Map::forceOnM_(out.tail<Map::OutputDim_>(), in.tail<Map::OutputDim_>());
+  }
+
+  template<typename Map>
+  inline size_t SE3<Map>::numberOfSubmanifolds() const
+  {
+    return 1;
+  }
+
+  template<typename Map>
+  inline bool SE3<Map>::isElementary() const
+  {
+    return true;
+  }
+
+  template<typename Map>
+  inline const Manifold& SE3<Map>::operator()(size_t i) const
+  {
+    mnf_assert(i < 1 && "invalid index");
+    return *this;
+  }
+
+  template<typename Map>
+  inline std::string SE3<Map>::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    std::string matPrefix = prefix + '[';
+    Eigen::IOFormat CleanFmt(prec, 0, ", ", "\n", matPrefix, "]");
+    std::stringstream ss;
+    ss << val.head<3>().format(CleanFmt) << std::endl;
+    ss << (Eigen::Map<const typename Map::DisplayType>(val.data() + 3)).format(CleanFmt);
+    return ss.str();
+  }
+
+  template<typename Map>
+  void SE3<Map>::createRandomPoint_(RefVec out, double coeff) const
+  {
+    setZero_(out);
+    TwistVector v(coeff*TwistVector::Random());
+    retractation(out, out, v);
+  }
+
+  template<typename Map>
+  inline Eigen::Vector3d SE3<Map>::translationIncrement(const Eigen::Matrix3d& R, const Eigen::Vector3d& nu, const Eigen::Vector3d& w)
+  {
+    return R*(SE3Algebra::leftJacobian(w)*nu);
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    //the translation is computed first, for out can be the same as x
+    Eigen::Vector3d dt = translationIncrement(Map::rotationMatrix(x.tail<Map::OutputDim_>()), v.head<3>(), v.tail<3>());
+    out.head<3>() = x.head<3>() + dt;
+    Map::retractation_(out.tail<Map::OutputDim_>(), x.tail<Map::OutputDim_>(), v.tail<3>());
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      Eigen::Vector3d dt = translationIncrement(Map::rotationMatrix(x.col(j).tail<Map::OutputDim_>()),
+                                                v.col(j).head<3>(), v.col(j).tail<3>());
+      out.col(j).head<3>() = x.col(j).head<3>() + dt;
+    }
+    Map::batchRetractation_(out.bottomRows<Map::OutputDim_>(), x.bottomRows<Map::OutputDim_>(), v.bottomRows<3>());
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    Eigen::Matrix<double, Map::OutputDim_, 1> r;
+    for (Index j = 0; j < x.rows(); ++j)
+    {
+      r = x.row(j).tail<Map::OutputDim_>().transpose();
+      Eigen::Vector3d dt = translationIncrement(Map::rotationMatrix(r), v.row(j).head<3>().transpose(),
+                                                v.row(j).tail<3>().transpose());
+      out.row(j).head<3>() = x.row(j).head<3>() + dt.transpose();
+    }
+    Map::batchRetractationSoA_(out.rightCols<Map::OutputDim_>(), x.rightCols<Map::OutputDim_>(), v.rightCols<3>());
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    Eigen::Vector3d w;
+    Map::pseudoLog_(w, x.tail<Map::OutputDim_>(), y.tail<Map::OutputDim_>());
+    Eigen::Vector3d t(Map::rotationMatrix(x.tail<Map::OutputDim_>()).transpose()*(y.head<3>() - x.head<3>()));
+    out.head<3>() = SE3Algebra::invLeftJacobian(w)*t;
+    out.tail<3>() = w;
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    Eigen::Vector3d w;
+    Map::pseudoLog0_(w, x.tail<Map::OutputDim_>());
+    out.head<3>() = SE3Algebra::invLeftJacobian(w)*x.head<3>();
+    out.tail<3>() = w;
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::setZero_(RefVec out) const
+  {
+    out.head<3>().setZero();
+    Map::setZero_(out.tail<Map::OutputDim_>());
+  }
+
+  template<typename Map>
+  inline Eigen::MatrixXd SE3<Map>::diffRetractation_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(Eigen::MatrixXd::Zero(RepDim_, 6));
+    J.topLeftCorner<3, 3>() = Map::rotationMatrix(x.tail<Map::OutputDim_>());
+    J.bottomRightCorner<Map::OutputDim_, 3>() = Map::diffRetractation_(x.tail<Map::OutputDim_>());
+    return J;
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    ReusableTemporaryMap& m = ReusableTemporaryMap::threadBuffer();
+    //the rotation part is done first: it reads only the last columns of in,
+    //and writes only the last columns of out.
+    Map::applyDiffRetractation_(out.rightCols<3>(), in.rightCols<Map::OutputDim_>(), x.tail<Map::OutputDim_>(), m);
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> a = m.getMap(in.rows(), 3);
+    a.noalias() = in.leftCols<3>()*Map::rotationMatrix(x.tail<Map::OutputDim_>());
+    out.leftCols<3>() = a;
+  }
+
+  template<typename Map>
+  inline Eigen::MatrixXd SE3<Map>::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::Vector3d w;
+    Map::pseudoLog0_(w, x.tail<Map::OutputDim_>());
+    Eigen::Matrix<double, 3, Map::OutputDim_> Jw = Map::diffPseudoLog0_(x.tail<Map::OutputDim_>());
+    Eigen::MatrixXd J(Eigen::MatrixXd::Zero(6, RepDim_));
+    J.topLeftCorner<3, 3>() = SE3Algebra::invLeftJacobian(w);
+    J.topRightCorner<3, Map::OutputDim_>() = SE3Algebra::diffInvLeftJacobian(w, x.head<3>())*Jw;
+    J.bottomRightCorner<3, Map::OutputDim_>() = Jw;
+    return J;
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    Eigen::Vector3d w;
+    Map::pseudoLog0_(w, x.tail<Map::OutputDim_>());
+    Eigen::Matrix<double, 3, Map::OutputDim_> Jw = Map::diffPseudoLog0_(x.tail<Map::OutputDim_>());
+    //a = [in_nu*V^-1, in_nu*dV^-1 + in_w, (in_nu*dV^-1 + in_w)*Jw]
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> a = ReusableTemporaryMap::threadBuffer().getMap(in.rows(), RepDim_ + 3);
+    a.leftCols<3>().noalias() = in.leftCols<3>()*SE3Algebra::invLeftJacobian(w);
+    a.middleCols<3>(3) = in.rightCols<3>();
+    a.middleCols<3>(3).noalias() += in.leftCols<3>()*SE3Algebra::diffInvLeftJacobian(w, x.head<3>());
+    a.rightCols<Map::OutputDim_>().noalias() = a.middleCols<3>(3)*Jw;
+    out.leftCols<3>() = a.leftCols<3>();
+    out.rightCols<Map::OutputDim_>() = a.rightCols<Map::OutputDim_>();
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec&, const ConstRefVec&) const
+  {
+    //same approximation as for SO3
+    out = in;
+  }
+
+  template<typename Map>
+  inline void SE3<Map>::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec&, const ConstRefVec&) const
+  {
+    out = in;
+  }
+
+  template<typename Map>
+  void SE3<Map>::tangentConstraint_(RefMat, const ConstRefVec&) const
+  {
+    //out is 0xt, no need to fill it
+  }
+
+  template<typename Map>
+  bool SE3<Map>::isInTxM_(const ConstRefVec&, const ConstRefVec&, const double&) const
+  {
+    return true;
+  }
+
+  template<typename Map>
+  void SE3<Map>::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec&) const
+  {
+    out = in;
+  }
+
+  template<typename Map>
+  void SE3<Map>::limitMap_(RefVec out) const
+  {
+    out.head<3>().setConstant(std::numeric_limits<double>::infinity());
+    out.tail<3>().setConstant(M_PI/sqrt(3));
+  }
+
+  template<typename Map>
+  void SE3<Map>::getTypicalMagnitude_(RefVec out) const
+  {
+    out = typicalMagnitude_;
+  }
+
+  template<typename Map>
+  void SE3<Map>::setTypicalMagnitude(double translationMagnitude, double rotationMagnitude)
+  {
+    Eigen::Matrix<double, 6, 1> magnitude;
+    magnitude << Eigen::Vector3d::Constant(translationMagnitude), Eigen::Vector3d::Constant(rotationMagnitude);
+    setTypicalMagnitude(magnitude);
+  }
+
+  template<typename Map>
+  void SE3<Map>::setTypicalMagnitude(const ConstRefVec& out)
+  {
+    typicalMagnitude_ = out;
+  }
+
+  template<typename Map>
+  long SE3<Map>::getTypeId() const
+  {
+    constexpr long typeId = ::utils::hash::computeHash("SE3", Map::hashName);
+    return typeId;
+  }
+
+  template<typename Map> struct StaticDims<SE3<Map> >
+  {
+    enum { Dim = 6, TangentDim = 6, RepresentationDim = SE3<Map>::RepDim_ };
+  };
+}
+#endif //_MANIFOLDS_SE3_H_
@@ -23,6 +23,7 @@
 #include <manifolds/defs.h>
 #include <manifolds/Manifold.h>
 #include <manifolds/ReusableTemporaryMap.h>
+#include <manifolds/StaticDims.h>
 #include <manifolds/utils.h>
 
 namespace mnf
@@ -48,9 +49,11 @@ namespace mnf
 
   protected:
     //map operations
-    virtual bool isInM_(const Eigen::VectorXd& val, const double& prec) const;
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
     virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
     virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
     virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
     virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
     virtual void setZero_(RefVec out) const;
@@ -65,7 +68,8 @@ namespace mnf
     virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
     virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
     virtual void limitMap_(RefVec out) const;
-    mutable ReusableTemporaryMap bufferMap_;
+
+    template<typename... M> friend class StaticCartesianProduct;
 
   private:
     Eigen::Vector3d typicalMagnitude_;
@@ -78,6 +82,8 @@ namespace mnf
   {
     name() = "SO3";
     setTypicalMagnitude(Eigen::Vector3d::Constant(M_PI));
+    //allocates the buffer of this thread now rather than at the first use
+    ReusableTemporaryMap::threadBuffer();
   }
   template<typename Map>
   inline SO3<Map>::SO3(double magnitude)
@@ -85,6 +91,7 @@ namespace mnf
   {
     name() = "SO3";
     setTypicalMagnitude(Eigen::Vector3d::Constant(magnitude));
+    ReusableTemporaryMap::threadBuffer();
   }
   template<typename Map>
   inline SO3<Map>::SO3(const ConstRefVec& magnitude)
@@ -93,10 +100,11 @@ namespace mnf
     mnf_assert(magnitude.size() == 3 && "magnitude on SO3 must be of size 3");
     name() = "SO3";
     setTypicalMagnitude(magnitude);
+    ReusableTemporaryMap::threadBuffer();
   }
 
   template<typename Map>
-  inline bool SO3<Map>::isInM_(const Eigen::VectorXd& val, const double& prec) const
+  inline bool SO3<Map>::isInM_(const ConstRefVec& val, const double& prec) const
   {
     return Map::isInM_(val, prec);
   }
@@ -150,6 +158,18 @@ namespace mnf
     Map::retractation_(out, x, v);
   }
 
+  template<typename Map>
+  inline void SO3<Map>::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    Map::batchRetractation_(out, x, v);
+  }
+
+  template<typename Map>
+  inline void SO3<Map>::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    Map::batchRetractationSoA_(out, x, v);
+  }
+
   template<typename Map>
   inline void SO3<Map>::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
   {
@@ -177,7 +197,7 @@ namespace mnf
   template<typename Map>
   inline void SO3<Map>::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
   {
-    Map::applyDiffRetractation_(out, in, x, bufferMap_);
+    Map::applyDiffRetractation_(out, in, x, ReusableTemporaryMap::threadBuffer());
   }
 
   template<typename Map>
@@ -189,19 +209,19 @@ namespace mnf
   template<typename Map>
   inline void SO3<Map>::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
   {
-    Map::applyDiffPseudoLog0_(out, in, x, bufferMap_);
+    Map::applyDiffPseudoLog0_(out, in, x, ReusableTemporaryMap::threadBuffer());
   }
 
   template<typename Map>
   inline void SO3<Map>::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
   {
-    Map::applyTransport_(out, in, x, v, bufferMap_);
+    Map::applyTransport_(out, in, x, v, ReusableTemporaryMap::threadBuffer());
   }
 
   template<typename Map>
   inline void SO3<Map>::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
   {
-    Map::applyInvTransport_(out, in, x, v, bufferMap_);
+    Map::applyInvTransport_(out, in, x, v, ReusableTemporaryMap::threadBuffer());
   }
 
   template<typename Map>
@@ -253,5 +273,10 @@ namespace mnf
     constexpr long typeId = ::utils::hash::computeHash("SO3", Map::hashName);
     return typeId;
   }
+
+  template<typename Map> struct StaticDims<SO3<Map> >
+  {
+    enum { Dim = 3, TangentDim = Map::InputDim_, RepresentationDim = Map::OutputDim_ };
+  };
 }
 #endif //_MANIFOLDS_SO3_H_
@@ -0,0 +1,105 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_SPD_H_
+#define _MANIFOLDS_SPD_H_
+
+#include <manifolds/defs.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/utils.h>
+
+namespace mnf
+{
+  /// \brief Manifold SPD(n) of the n x n symmetric positive-definite
+  /// matrices, of dimension n(n+1)/2.\n
+  /// A point \f$ S = LL^T \f$ is represented by its Cholesky factor L, packed
+  /// column by column: the lower part of column j (from the diagonal) is
+  /// stored right after the one of column j-1, as in the LAPACK packed
+  /// storage. A point is thus in the manifold iff the diagonal of L is
+  /// positive, i.e. iff it is the result of a successful Cholesky
+  /// decomposition. Tangent vectors are lower triangular matrices, packed the
+  /// same way.\n
+  /// The geometry is the one of the log-Cholesky metric (Lin, 2019), for which
+  /// the exponential, logarithm and parallel transport are closed form and
+  /// act separately on each coefficient of L:
+  /// - off-diagonal: \f$ L \oplus X = L + X \f$,
+  /// - diagonal: \f$ L_{jj} \oplus X_{jj} = L_{jj}\exp(X_{jj}/L_{jj}) \f$.
+  ///
+  /// Hence, no decomposition is needed but for the conversion from a full
+  /// matrix. The zero is the identity matrix.
+  class MANIFOLDS_API SPD : public Manifold
+  {
+  public:
+    /// \brief Constructor
+    /// \param n size of the matrices
+    SPD(Index n);
+    SPD(Index n, double magnitude);
+
+    /// \brief Size n of the matrices
+    Index matrixSize() const;
+    /// \brief Index of the element (i, j), i >= j, in the packed storage
+    Index packedIndex(Index i, Index j) const;
+
+    /// \brief out = LL^T, where L is the factor packed in x
+    void toMatrix(RefMat out, const ConstRefVec& x) const;
+    /// \brief Packs in out the Cholesky factor of the lower part of S.
+    /// Returns false if S is not positive definite, in which case out is not
+    /// a point of the manifold. Does not allocate.
+    bool fromMatrix(RefVec out, const ConstRefMat& S) const;
+    /// \brief Log-Cholesky distance between x and y
+    double distance(const ConstRefVec& x, const ConstRefVec& y) const;
+
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+    void setTypicalMagnitude(double magnitude);
+    void setTypicalMagnitude(const ConstRefVec& out);
+    virtual bool isElementary() const;
+    virtual long getTypeId() const;
+
+  protected:
+    //map operations
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+
+  private:
+    Index n_;
+    Eigen::VectorXd typicalMagnitude_;
+  };
+}
+#endif //_MANIFOLDS_SPD_H_
@@ -0,0 +1,129 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_SN_H_
+#define _MANIFOLDS_SN_H_
+
+#include <manifolds/defs.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/StaticDims.h>
+#include <manifolds/utils.h>
+
+namespace mnf
+{
+  /// \brief Manifold representing the unit sphere \f$ S^n \f$ of
+  /// \f$ \mathbb{R}^{n+1} \f$, of dimension n.\n
+  /// The points and the tangent vectors are vectors of \f$ \mathbb{R}^{n+1} \f$,
+  /// a tangent vector at x being orthogonal to x. The retractation is the
+  /// projection \f$ x \oplus v = (x+v)/\|x+v\| \f$ and the pseudoLog the
+  /// Riemannian logarithm, as for S2. The zero is the first vector of the
+  /// canonical basis.\n
+  /// The column-wise kernels of the batch methods are exposed as static
+  /// methods, to be applied on any matrix whose columns are points of the
+  /// sphere.
+  class MANIFOLDS_API Sn : public Manifold
+  {
+  public:
+    /// \brief Constructor
+    /// \param n the dimension of the sphere, embedded in \f$\mathbb{R}^{n+1}\f$
+    Sn(Index n);
+    Sn(Index n, double magnitude);
+    Sn(Index n, const ConstRefVec& magnitude);
+
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+    void setTypicalMagnitude(double magnitude);
+    void setTypicalMagnitude(const ConstRefVec& out);
+    /// \brief Geodesic distance between x and y
+    double distance(const ConstRefVec& x, const ConstRefVec& y) const;
+    /// \brief projects vector in on TxM
+    void projVec(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual bool isElementary() const;
+    virtual long getTypeId() const;
+
+    /// \brief out_j = (x_j + v_j)/|x_j + v_j| for each column j.
+    /// out can be x or v.
+    static void retractCols(RefMat out, const ConstRefMat& x, const ConstRefMat& v);
+    /// \brief out_j = Log_{x_j}(y_j) for each column j. y_j must not be the
+    /// antipode of x_j. out can be x or y.
+    static void logCols(RefMat out, const ConstRefMat& x, const ConstRefMat& y);
+    /// \brief out_j = in_j - (x_j.in_j) x_j for each column j: projection of
+    /// in_j on the tangent space at x_j. out can be in or x.
+    static void projCols(RefMat out, const ConstRefMat& in, const ConstRefMat& x);
+    /// \brief out = in - (in x) x^T: projection of each row of in on the
+    /// tangent space at x. out can be in.
+    static void projRows(RefMat out, const ConstRefMat& in, const ConstRefVec& x);
+    /// \brief Structure-of-arrays version of retractCols: row j of x and v
+    /// is the j-th point and tangent vector. out can be x or v.
+    static void retractRows(RefMat out, const ConstRefMat& x, const ConstRefMat& v);
+    /// \brief out_j = Log_{e0}(x_j) for each column j. out can be x.
+    static void log0Cols(RefMat out, const ConstRefMat& x);
+    /// \brief Jacobian of Log_{e0} at x
+    static void diffLog0(RefMat J, const ConstRefVec& x);
+    /// \brief out = in*diffLog0(x). out can be in.
+    static void applyDiffLog0(RefMat out, const ConstRefMat& in, const ConstRefVec& x);
+
+  protected:
+    //map operations
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+
+    template<typename... M> friend class StaticCartesianProduct;
+
+  private:
+    Eigen::VectorXd typicalMagnitude_;
+  };
+
+  /// \brief Sn whose dimension is known at compile time, to be used in a
+  /// StaticCartesianProduct
+  template<int N>
+  class SnN : public Sn
+  {
+  public:
+    SnN() : Sn(N) {}
+    SnN(double magnitude) : Sn(N, magnitude) {}
+    SnN(const ConstRefVec& magnitude) : Sn(N, magnitude) {}
+  };
+
+  template<int N> struct StaticDims<SnN<N> >
+  {
+    enum { Dim = N, TangentDim = N + 1, RepresentationDim = N + 1 };
+  };
+}
+#endif //_MANIFOLDS_SN_H_
@@ -0,0 +1,641 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_STATIC_CARTESIAN_PRODUCT_H_
+#define _MANIFOLDS_STATIC_CARTESIAN_PRODUCT_H_
+
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+
+#include <manifolds/defs.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/StaticDims.h>
+#include <manifolds/utils.h>
+
+namespace mnf
+{
+  namespace internal
+  {
+    /// Size of M in the space D (R or T), or its dimension if D is F.
+    template<int D, typename M> struct StaticSize
+    {
+      enum { value = D == R ? static_cast<int>(StaticDims<M>::RepresentationDim)
+                            : (D == T ? static_cast<int>(StaticDims<M>::TangentDim)
+                                      : static_cast<int>(StaticDims<M>::Dim)) };
+    };
+
+    /// Sum of the sizes of the manifolds Ms in the space D
+    template<int D, typename... Ms> struct StaticSum
+    {
+      enum { value = 0 };
+    };
+
+    template<int D, typename M0, typename... Ms> struct StaticSum<D, M0, Ms...>
+    {
+      enum { value = StaticSize<D, M0>::value + StaticSum<D, Ms...>::value };
+    };
+
+    /// Start index of the I-th manifold of Ms in the space D
+    template<int D, size_t I, typename... Ms> struct StaticStart;
+
+    template<int D, typename M0, typename... Ms> struct StaticStart<D, 0, M0, Ms...>
+    {
+      enum { value = 0 };
+    };
+
+    template<int D, size_t I, typename M0, typename... Ms> struct StaticStart<D, I, M0, Ms...>
+    {
+      enum { value = StaticSize<D, M0>::value + StaticStart<D, I - 1, Ms...>::value };
+    };
+  }
+
+  /// \brief Manifold representing the cartesian product of elementary
+  /// manifolds whose types are known at compile time, e.g.
+  /// StaticCartesianProduct<RealSpaceN<3>, SO3<ExpMapQuaternion>, S2>.\n
+  /// The product owns its submanifolds. The dimensions and start indices of
+  /// the submanifolds are compile-time constants, their views are fixed-size
+  /// blocks and their operations are called without virtual dispatch nor
+  /// assertions on the submanifolds.
+  template<typename... M>
+  class StaticCartesianProduct : public Manifold
+  {
+  public:
+    static_assert(sizeof...(M) > 0, "A StaticCartesianProduct needs at least one submanifold");
+
+    /// \brief Number of submanifolds
+    static const size_t N = sizeof...(M);
+
+    /// \brief Type of the I-th submanifold
+    template<size_t I> using Leaf = typename std::tuple_element<I, std::tuple<M...> >::type;
+
+    static const int Dim_ = internal::StaticSum<F, M...>::value;
+    static const int TangentDim_ = internal::StaticSum<T, M...>::value;
+    static const int RepresentationDim_ = internal::StaticSum<R, M...>::value;
+
+    StaticCartesianProduct();
+
+    /// \brief Access to the I-th submanifold, e.g. to set its typical magnitude
+    template<size_t I> Leaf<I>& leaf() { return std::get<I>(leaves_); }
+    template<size_t I> const Leaf<I>& leaf() const { return std::get<I>(leaves_); }
+
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+
+    virtual bool isElementary() const;
+
+    virtual bool hasIdentityJacobians() const;
+
+    virtual void display(std::string prefix = "") const;
+
+    virtual long getTypeId() const;
+
+  protected:
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+
+    virtual Index startR(size_t i) const;
+    virtual Index startT(size_t i) const;
+
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const;
+    virtual void diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+
+  private:
+    //We forbid copy: the pointers in submanifolds_ refer to leaves_
+    StaticCartesianProduct(const StaticCartesianProduct&);
+    StaticCartesianProduct& operator=(const StaticCartesianProduct&);
+
+    template<size_t I> struct Tag {};
+
+    template<int D, size_t I> struct Size
+    {
+      enum { value = internal::StaticSize<D, Leaf<I> >::value };
+    };
+
+    template<int D, size_t I> struct Start
+    {
+      enum { value = internal::StaticStart<D, I, M...>::value };
+    };
+
+    //Each operation is unrolled at compile time: the fooAt version taking
+    //Tag<I> processes the I-th submanifold and calls the one for I+1, the
+    //version taking Tag<N> stops the recursion.
+    template<size_t I> void init(Tag<I>);
+    void init(Tag<N>) {}
+    template<size_t I> bool isInMAt(const ConstRefVec& val, const double& prec, Tag<I>) const;
+    bool isInMAt(const ConstRefVec&, const double&, Tag<N>) const { return true; }
+    template<size_t I> void forceOnMAt(RefVec out, const ConstRefVec& in, Tag<I>) const;
+    void forceOnMAt(RefVec, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void createRandomPointAt(RefVec out, double coeff, Tag<I>) const;
+    void createRandomPointAt(RefVec, double, Tag<N>) const {}
+    template<size_t I> void retractationAt(RefVec out, const ConstRefVec& x, const ConstRefVec& v, Tag<I>) const;
+    void retractationAt(RefVec, const ConstRefVec&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void batchRetractationAt(RefMat out, const ConstRefMat& x, const ConstRefMat& v, Tag<I>) const;
+    void batchRetractationAt(RefMat, const ConstRefMat&, const ConstRefMat&, Tag<N>) const {}
+    template<size_t I> void pseudoLogAt(RefVec out, const ConstRefVec& x, const ConstRefVec& y, Tag<I>) const;
+    void pseudoLogAt(RefVec, const ConstRefVec&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void pseudoLog0At(RefVec out, const ConstRefVec& x, Tag<I>) const;
+    void pseudoLog0At(RefVec, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void setZeroAt(RefVec out, Tag<I>) const;
+    void setZeroAt(RefVec, Tag<N>) const {}
+    template<size_t I> void diffRetractationAt(RefMat J, const ConstRefVec& x, Tag<I>) const;
+    void diffRetractationAt(RefMat, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void applyDiffRetractationAt(RefMat out, const ConstRefMat& in, const ConstRefVec& x, Tag<I>) const;
+    void applyDiffRetractationAt(RefMat, const ConstRefMat&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void diffPseudoLog0At(RefMat J, const ConstRefVec& x, Tag<I>) const;
+    void diffPseudoLog0At(RefMat, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void applyDiffPseudoLog0At(RefMat out, const ConstRefMat& in, const ConstRefVec& x, Tag<I>) const;
+    void applyDiffPseudoLog0At(RefMat, const ConstRefMat&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void diffRetractationBlocksAt(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT, Tag<I>) const;
+    void diffRetractationBlocksAt(BlockDiagonalMatrix&, const ConstRefVec&, Index, Index, Tag<N>) const {}
+    template<size_t I> void diffPseudoLog0BlocksAt(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR, Tag<I>) const;
+    void diffPseudoLog0BlocksAt(BlockDiagonalMatrix&, const ConstRefVec&, Index, Index, Tag<N>) const {}
+    template<size_t I> void applyTransportAt(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v, Tag<I>) const;
+    void applyTransportAt(RefMat, const ConstRefMat&, const ConstRefVec&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void applyInvTransportAt(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v, Tag<I>) const;
+    void applyInvTransportAt(RefMat, const ConstRefMat&, const ConstRefVec&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void tangentConstraintAt(RefMat out, const ConstRefVec& x, Index k, Tag<I>) const;
+    void tangentConstraintAt(RefMat, const ConstRefVec&, Index, Tag<N>) const {}
+    template<size_t I> bool isInTxMAt(const ConstRefVec& x, const ConstRefVec& v, const double& prec, Tag<I>) const;
+    bool isInTxMAt(const ConstRefVec&, const ConstRefVec&, const double&, Tag<N>) const { return true; }
+    template<size_t I> void forceOnTxMAt(RefVec out, const ConstRefVec& in, const ConstRefVec& x, Tag<I>) const;
+    void forceOnTxMAt(RefVec, const ConstRefVec&, const ConstRefVec&, Tag<N>) const {}
+    template<size_t I> void limitMapAt(RefVec out, Tag<I>) const;
+    void limitMapAt(RefVec, Tag<N>) const {}
+    template<size_t I> void getTypicalMagnitudeAt(RefVec out, Tag<I>) const;
+    void getTypicalMagnitudeAt(RefVec, Tag<N>) const {}
+
+    /// \brief The submanifolds
+    std::tuple<M...> leaves_;
+
+    /// \brief Pointers on the submanifolds, for the runtime interface
+    const Manifold* submanifolds_[N];
+
+    /// \brief Start indices of the submanifolds, for the runtime interface
+    Index startIndexR_[N];
+    Index startIndexT_[N];
+  };
+
+  template<typename... M> const size_t StaticCartesianProduct<M...>::N;
+  template<typename... M> const int StaticCartesianProduct<M...>::Dim_;
+  template<typename... M> const int StaticCartesianProduct<M...>::TangentDim_;
+  template<typename... M> const int StaticCartesianProduct<M...>::RepresentationDim_;
+
+  template<typename... M>
+  inline StaticCartesianProduct<M...>::StaticCartesianProduct()
+    : Manifold(Dim_, TangentDim_, RepresentationDim_)
+  {
+    init(Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::init(Tag<I>)
+  {
+    const Manifold& m = std::get<I>(leaves_);
+    //the extra parentheses protect the commas from the macro version of mnf_assert
+    mnf_assert((m.dim() == Size<F, I>::value && m.tangentDim() == Size<T, I>::value
+                && m.representationDim() == Size<R, I>::value));
+    m.lock();
+    if (I > 0)
+      name() += "x";
+    name() += m.name();
+    submanifolds_[I] = &m;
+    startIndexR_[I] = Start<R, I>::value;
+    startIndexT_[I] = Start<T, I>::value;
+    init(Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline size_t StaticCartesianProduct<M...>::numberOfSubmanifolds() const
+  {
+    return N;
+  }
+
+  template<typename... M>
+  inline const Manifold& StaticCartesianProduct<M...>::operator()(size_t i) const
+  {
+    mnf_assert(i < N && "invalid index");
+    return *submanifolds_[i];
+  }
+
+  template<typename... M>
+  inline Index StaticCartesianProduct<M...>::startR(size_t i) const
+  {
+    mnf_assert(i < N && "invalid index");
+    return startIndexR_[i];
+  }
+
+  template<typename... M>
+  inline Index StaticCartesianProduct<M...>::startT(size_t i) const
+  {
+    mnf_assert(i < N && "invalid index");
+    return startIndexT_[i];
+  }
+
+  template<typename... M>
+  inline std::string StaticCartesianProduct<M...>::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    std::stringstream ss;
+    for (size_t i = 0; i < N; ++i)
+    {
+      if (i > 0)
+        ss << std::endl;
+      ss << submanifolds_[i]->toString(getConstView<R>(val, i), prefix + "  ", prec);
+    }
+    return ss.str();
+  }
+
+  template<typename... M>
+  inline bool StaticCartesianProduct<M...>::isElementary() const
+  {
+    return false;
+  }
+
+  template<typename... M>
+  inline bool StaticCartesianProduct<M...>::hasIdentityJacobians() const
+  {
+    bool b = true;
+    for (size_t i = 0; i < N && b; ++i)
+      b = submanifolds_[i]->hasIdentityJacobians();
+    return b;
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::display(std::string prefix) const
+  {
+    for (size_t i = 0; i < N; ++i)
+      std::cout << prefix << submanifolds_[i]->name() << std::endl;
+  }
+
+  template<typename... M>
+  inline long StaticCartesianProduct<M...>::getTypeId() const
+  {
+    return ::utils::hash::computeHash("StaticCartesianProduct");
+  }
+
+  template<typename... M>
+  inline bool StaticCartesianProduct<M...>::isInM_(const ConstRefVec& val, const double& prec) const
+  {
+    return isInMAt(val, prec, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline bool StaticCartesianProduct<M...>::isInMAt(const ConstRefVec& val, const double& prec, Tag<I>) const
+  {
+    return std::get<I>(leaves_).Leaf<I>::isInM_(val.template segment<Size<R, I>::value>(Start<R, I>::value), prec)
+      && isInMAt(val, prec, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    forceOnMAt(out, in, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::forceOnMAt(RefVec out, const ConstRefVec& in, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::forceOnM_(out.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                             in.template segment<Size<R, I>::value>(Start<R, I>::value));
+    forceOnMAt(out, in, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::createRandomPoint_(RefVec out, double coeff) const
+  {
+    createRandomPointAt(out, coeff, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::createRandomPointAt(RefVec out, double coeff, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::createRandomPoint_(out.template segment<Size<R, I>::value>(Start<R, I>::value), coeff);
+    createRandomPointAt(out, coeff, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    retractationAt(out, x, v, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::retractationAt(RefVec out, const ConstRefVec& x, const ConstRefVec& v, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::retractation_(out.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                 x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                 v.template segment<Size<T, I>::value>(Start<T, I>::value));
+    retractationAt(out, x, v, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    batchRetractationAt(out, x, v, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::batchRetractationAt(RefMat out, const ConstRefMat& x, const ConstRefMat& v, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::batchRetractation_(out.template middleRows<Size<R, I>::value>(Start<R, I>::value),
+                                                      x.template middleRows<Size<R, I>::value>(Start<R, I>::value),
+                                                      v.template middleRows<Size<T, I>::value>(Start<T, I>::value));
+    batchRetractationAt(out, x, v, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    pseudoLogAt(out, x, y, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::pseudoLogAt(RefVec out, const ConstRefVec& x, const ConstRefVec& y, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::pseudoLog_(out.template segment<Size<T, I>::value>(Start<T, I>::value),
+                                              x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                              y.template segment<Size<R, I>::value>(Start<R, I>::value));
+    pseudoLogAt(out, x, y, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    pseudoLog0At(out, x, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::pseudoLog0At(RefVec out, const ConstRefVec& x, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::pseudoLog0_(out.template segment<Size<T, I>::value>(Start<T, I>::value),
+                                               x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    pseudoLog0At(out, x, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::setZero_(RefVec out) const
+  {
+    setZeroAt(out, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::setZeroAt(RefVec out, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::setZero_(out.template segment<Size<R, I>::value>(Start<R, I>::value));
+    setZeroAt(out, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline Eigen::MatrixXd StaticCartesianProduct<M...>::diffRetractation_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(RepresentationDim_, TangentDim_);
+    J.setZero();
+    diffRetractationAt(J, x, Tag<0>());
+    return J;
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::diffRetractationAt(RefMat J, const ConstRefVec& x, Tag<I>) const
+  {
+    J.template block<Size<R, I>::value, Size<T, I>::value>(Start<R, I>::value, Start<T, I>::value)
+      = std::get<I>(leaves_).Leaf<I>::diffRetractation_(x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    diffRetractationAt(J, x, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    applyDiffRetractationAt(out, in, x, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::applyDiffRetractationAt(RefMat out, const ConstRefMat& in, const ConstRefVec& x, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::applyDiffRetractation_(out.template middleCols<Size<T, I>::value>(Start<T, I>::value),
+                                                          in.template middleCols<Size<R, I>::value>(Start<R, I>::value),
+                                                          x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    applyDiffRetractationAt(out, in, x, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline Eigen::MatrixXd StaticCartesianProduct<M...>::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(TangentDim_, RepresentationDim_);
+    J.setZero();
+    diffPseudoLog0At(J, x, Tag<0>());
+    return J;
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::diffPseudoLog0At(RefMat J, const ConstRefVec& x, Tag<I>) const
+  {
+    J.template block<Size<T, I>::value, Size<R, I>::value>(Start<T, I>::value, Start<R, I>::value)
+      = std::get<I>(leaves_).Leaf<I>::diffPseudoLog0_(x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    diffPseudoLog0At(J, x, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    applyDiffPseudoLog0At(out, in, x, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::applyDiffPseudoLog0At(RefMat out, const ConstRefMat& in, const ConstRefVec& x, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::applyDiffPseudoLog0_(out.template middleCols<Size<R, I>::value>(Start<R, I>::value),
+                                                        in.template middleCols<Size<T, I>::value>(Start<T, I>::value),
+                                                        x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    applyDiffPseudoLog0At(out, in, x, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const
+  {
+    diffRetractationBlocksAt(J, x, startR, startT, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::diffRetractationBlocksAt(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::diffRetractationBlocks_(J, x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                           startR + Start<R, I>::value, startT + Start<T, I>::value);
+    diffRetractationBlocksAt(J, x, startR, startT, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const
+  {
+    diffPseudoLog0BlocksAt(J, x, startT, startR, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::diffPseudoLog0BlocksAt(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::diffPseudoLog0Blocks_(J, x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                         startT + Start<T, I>::value, startR + Start<R, I>::value);
+    diffPseudoLog0BlocksAt(J, x, startT, startR, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    applyTransportAt(out, in, x, v, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::applyTransportAt(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::applyTransport_(out.template middleRows<Size<T, I>::value>(Start<T, I>::value),
+                                                   in.template middleRows<Size<T, I>::value>(Start<T, I>::value),
+                                                   x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                   v.template segment<Size<T, I>::value>(Start<T, I>::value));
+    applyTransportAt(out, in, x, v, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    applyInvTransportAt(out, in, x, v, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::applyInvTransportAt(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::applyInvTransport_(out.template middleCols<Size<T, I>::value>(Start<T, I>::value),
+                                                      in.template middleCols<Size<T, I>::value>(Start<T, I>::value),
+                                                      x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                      v.template segment<Size<T, I>::value>(Start<T, I>::value));
+    applyInvTransportAt(out, in, x, v, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::tangentConstraint_(RefMat out, const ConstRefVec& x) const
+  {
+    out.setZero();
+    tangentConstraintAt(out, x, 0, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::tangentConstraintAt(RefMat out, const ConstRefVec& x, Index k, Tag<I>) const
+  {
+    const Index s = Size<T, I>::value - Size<F, I>::value;
+    std::get<I>(leaves_).Leaf<I>::tangentConstraint_(out.block(k, Start<T, I>::value, s, Size<T, I>::value),
+                                                      x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    tangentConstraintAt(out, x, k + s, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline bool StaticCartesianProduct<M...>::isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const
+  {
+    return isInTxMAt(x, v, prec, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline bool StaticCartesianProduct<M...>::isInTxMAt(const ConstRefVec& x, const ConstRefVec& v, const double& prec, Tag<I>) const
+  {
+    return std::get<I>(leaves_).Leaf<I>::isInTxM_(x.template segment<Size<R, I>::value>(Start<R, I>::value),
+                                                   v.template segment<Size<T, I>::value>(Start<T, I>::value), prec)
+      && isInTxMAt(x, v, prec, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
+  {
+    forceOnTxMAt(out, in, x, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::forceOnTxMAt(RefVec out, const ConstRefVec& in, const ConstRefVec& x, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::forceOnTxM_(out.template segment<Size<T, I>::value>(Start<T, I>::value),
+                                               in.template segment<Size<T, I>::value>(Start<T, I>::value),
+                                               x.template segment<Size<R, I>::value>(Start<R, I>::value));
+    forceOnTxMAt(out, in, x, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::limitMap_(RefVec out) const
+  {
+    limitMapAt(out, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::limitMapAt(RefVec out, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::limitMap_(out.template segment<Size<T, I>::value>(Start<T, I>::value));
+    limitMapAt(out, Tag<I + 1>());
+  }
+
+  template<typename... M>
+  inline void StaticCartesianProduct<M...>::getTypicalMagnitude_(RefVec out) const
+  {
+    getTypicalMagnitudeAt(out, Tag<0>());
+  }
+
+  template<typename... M>
+  template<size_t I>
+  inline void StaticCartesianProduct<M...>::getTypicalMagnitudeAt(RefVec out, Tag<I>) const
+  {
+    std::get<I>(leaves_).Leaf<I>::getTypicalMagnitude_(out.template segment<Size<T, I>::value>(Start<T, I>::value));
+    getTypicalMagnitudeAt(out, Tag<I + 1>());
+  }
+}
+
+#endif //_MANIFOLDS_STATIC_CARTESIAN_PRODUCT_H_
@@ -0,0 +1,29 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_STATIC_DIMS_H_
+#define _MANIFOLDS_STATIC_DIMS_H_
+
+namespace mnf
+{
+  /// \brief Compile-time dimensions of the elementary manifolds that can be
+  /// used in a StaticCartesianProduct. Each manifold specializes it in its own
+  /// header, with the enum values Dim, TangentDim and RepresentationDim.
+  template<typename M> struct StaticDims;
+}
+
+#endif //_MANIFOLDS_STATIC_DIMS_H_
@@ -0,0 +1,133 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_STIEFEL_H_
+#define _MANIFOLDS_STIEFEL_H_
+
+#include <manifolds/defs.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/utils.h>
+
+namespace mnf
+{
+  /// \brief Manifold St(n, p) of the n x p matrices with orthonormal columns,
+  /// i.e. of the orthonormal p-frames of \f$ \mathbb{R}^n \f$.\n
+  /// A point X is represented by its matrix in column-major order, and a
+  /// tangent vector at X by a n x p matrix V such that
+  /// \f$ X^T V + V^T X = 0 \f$. The zero is made of the p first columns of
+  /// the identity.\n
+  /// Two retractations are available:
+  /// - QR: \f$ R_X(V) = qf(X+V) \f$, the Q factor of the thin QR
+  ///   decomposition of X+V with positive diagonal in R,
+  /// - Cayley: \f$ R_X(V) = (I-W/2)^{-1}(I+W/2)X \f$ with the skew matrix
+  ///   \f$ W = P_X V X^T - X V^T P_X \f$, \f$ P_X = I - XX^T/2 \f$, evaluated
+  ///   through its rank-2p form so that only a 2p x 2p system is solved.
+  ///
+  /// Both run in O(np^2). pseudoLog and the jacobian of pseudoLog0 solve in
+  /// addition p linear systems of size at most p, in O(p^4), applyDiffPseudoLog0
+  /// doing so once per row. All operations work on slices of at most
+  /// 3np+9p^2+p doubles of the thread buffer of ReusableTemporaryMap, which the
+  /// constructor preallocates for the calling thread, and never allocate
+  /// afterward (but for diffRetractation and diffPseudoLog0 that return a
+  /// matrix).\n
+  /// Whatever the retractation, pseudoLog is the exact inverse of the QR
+  /// retractation. It is thus only a first order approximation of the inverse
+  /// of the Cayley retractation. It requires the leading principal minors of
+  /// \f$ X^T Y \f$ to be non zero, which is the case when Y is close enough
+  /// to X.
+  class MANIFOLDS_API Stiefel : public Manifold
+  {
+  public:
+    enum Retractation
+    {
+      QR,
+      Cayley
+    };
+
+    /// \brief Constructor
+    /// \param n dimension of the ambient space
+    /// \param p number of vectors in the frame, 1 <= p <= n
+    /// \param retractation choice of the retractation
+    Stiefel(Index n, Index p, Retractation retractation = QR);
+    Stiefel(Index n, Index p, double magnitude, Retractation retractation = QR);
+
+    /// \brief Dimension n of the ambient space
+    Index ambientDim() const;
+    /// \brief Number p of vectors of the frame
+    Index frameSize() const;
+    /// \brief Retractation used by this manifold
+    Retractation retractationType() const;
+
+    virtual size_t numberOfSubmanifolds() const;
+    virtual const Manifold& operator()(size_t i) const;
+
+    virtual void createRandomPoint_(RefVec out, double coeff) const;
+
+    virtual std::string toString(const ConstRefVec& val, const std::string& prefix = "", int prec = 6) const;
+    virtual void getTypicalMagnitude_(RefVec out) const;
+    void setTypicalMagnitude(double magnitude);
+    void setTypicalMagnitude(const ConstRefVec& out);
+    virtual bool isElementary() const;
+    virtual long getTypeId() const;
+
+  protected:
+    //map operations
+    virtual bool isInM_(const ConstRefVec& val, const double& prec) const;
+    virtual void forceOnM_(RefVec out, const ConstRefVec& in) const;
+    virtual void retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const;
+    virtual void pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const;
+    virtual void pseudoLog0_(RefVec out, const ConstRefVec& x) const;
+    virtual void setZero_(RefVec out) const;
+    virtual Eigen::MatrixXd diffRetractation_(const ConstRefVec& x) const;
+    virtual void applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual Eigen::MatrixXd diffPseudoLog0_(const ConstRefVec& x) const;
+    virtual void applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const;
+    virtual void applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+    virtual void applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const;
+
+    virtual void tangentConstraint_(RefMat out, const ConstRefVec& x) const;
+    virtual bool isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const;
+    virtual void forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const;
+    virtual void limitMap_(RefVec out) const;
+
+  private:
+    typedef Eigen::Map<Eigen::MatrixXd> MatMap;
+    typedef Eigen::Map<const Eigen::MatrixXd> ConstMatMap;
+
+    /// \brief View of a point or tangent vector as a n x p matrix
+    MatMap mat(RefVec v) const;
+    ConstMatMap mat(const ConstRefVec& v) const;
+
+    /// \brief Start of a thread buffer holding at least workspaceSize_ doubles,
+    /// plus extra doubles
+    double* workspace(Index extra = 0) const;
+
+    /// \brief out = R_X(V) with the selected retractation, using the
+    /// workspace ws of at least 2np+7p^2 doubles. out may alias X or V.
+    void retract(MatMap out, const ConstMatMap& X, const ConstMatMap& V, double* ws) const;
+
+    Index n_;
+    Index p_;
+    Retractation retractationType_;
+    /// \brief Number of doubles needed by the operations but the jacobians
+    Index workspaceSize_;
+    Eigen::VectorXd typicalMagnitude_;
+  };
+}
+#endif //_MANIFOLDS_STIEFEL_H_
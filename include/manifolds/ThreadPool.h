@@ -0,0 +1,130 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_THREAD_POOL_H_
+#define _MANIFOLDS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <manifolds/defs.h>
+
+namespace mnf
+{
+  /// \brief Pool of worker threads running parallel loops with work stealing.\n
+  /// The range of a loop is first split evenly between the threads, including
+  /// the calling one. Each thread processes its own range chunk by chunk from
+  /// the front, and once it is empty steals the back half of the range of
+  /// another thread, so that threads finishing early take over the remaining
+  /// work without any shared cursor.\n
+  /// A loop started from inside another loop, or while the pool is busy with
+  /// a loop from another thread, is run serially by the calling thread.
+  class MANIFOLDS_API ThreadPool
+  {
+  public:
+    /// \brief Placement of the worker threads on the cores
+    enum Affinity
+    {
+      NoAffinity,   ///< the system schedules the threads
+      PinToCores    ///< worker i runs only on core (i+1) modulo the number of cores
+    };
+
+    /// \brief Creates a pool with nThreads worker threads. With the default
+    /// value, one less than the number of hardware threads is used, the
+    /// calling thread being the last one.\n
+    /// PinToCores is only supported on Linux, and ignored elsewhere.
+    explicit ThreadPool(size_t nThreads = static_cast<size_t>(-1), Affinity affinity = NoAffinity);
+    ~ThreadPool();
+
+    /// \brief Number of threads working on a loop, including the calling one
+    size_t size() const;
+
+    Affinity affinity() const;
+
+    /// \brief Calls f(b, e) on disjoint ranges [b, e) covering [begin, end),
+    /// of at most grain elements each, and returns once all of them are done.
+    /// If some calls throw, the first exception caught is rethrown.
+    void parallelFor(Index begin, Index end, Index grain, const std::function<void(Index, Index)>& f);
+
+    /// \brief Pool shared by the whole library
+    static ThreadPool& global();
+
+  private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    /// \brief Range of indices still to be processed by a thread, relative to
+    /// the beginning of the loop, packed as (begin << 32 | end) so that it can
+    /// be updated with a single compare-and-swap. The padding keeps two
+    /// ranges on different cache lines.
+    struct Slot
+    {
+      std::atomic<std::uint64_t> range;
+      char padding[64 - sizeof(std::uint64_t)];
+    };
+
+    void workerLoop(size_t id);
+    /// \brief Processes the range of thread id, then steals from the others
+    /// until all ranges are empty
+    void runChunks(size_t id);
+    /// \brief Takes the next chunk from the front of the range of thread id.
+    /// Returns false if it is empty.
+    bool takeChunk(size_t id, Index& b, Index& e);
+    /// \brief Moves the back half of the range of another thread into the
+    /// range of thread id. Returns false if all the ranges are empty.
+    bool steal(size_t id);
+
+    std::vector<std::thread> workers_;
+    Affinity affinity_;
+    /// \brief One slot per thread, the calling thread using slot 0
+    std::unique_ptr<Slot[]> slots_;
+    /// \brief Taken for the whole duration of a loop
+    std::mutex busy_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+
+    const std::function<void(Index, Index)>* job_;
+    Index begin_;
+    Index grain_;
+    /// \brief Number of workers that did not finish the current loop
+    size_t active_;
+    /// \brief Incremented at each new loop
+    unsigned long generation_;
+    bool stop_;
+    std::exception_ptr error_;
+  };
+
+  inline size_t ThreadPool::size() const
+  {
+    return workers_.size() + 1;
+  }
+
+  inline ThreadPool::Affinity ThreadPool::affinity() const
+  {
+    return affinity_;
+  }
+}
+
+#endif //_MANIFOLDS_THREAD_POOL_H_
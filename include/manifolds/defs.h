@@ -35,5 +35,15 @@ namespace mnf
 
 #include <manifolds/manifolds_api.h>
 
+/// \internal Used on the batch kernels: with gcc on x86-64 linux, the kernel is
+/// compiled for several instruction sets and the best one for the CPU running
+/// the code is selected when the library is loaded. Define
+/// MNF_NO_TARGET_CLONES to disable it.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__) && !defined(MNF_NO_TARGET_CLONES)
+#  define MNF_TARGET_CLONES __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#  define MNF_TARGET_CLONES
+#endif
+
 #endif //_MANIFOLDS_DEFS_H_
 
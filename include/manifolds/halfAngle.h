@@ -0,0 +1,61 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#ifndef _MANIFOLDS_HALF_ANGLE_H_
+#define _MANIFOLDS_HALF_ANGLE_H_
+
+namespace mnf
+{
+  /// \brief cos(t/2) as a polynomial of u = -(t/2)^2.
+  /// For t < pi, the truncation error is below 1e-16.
+  /// cos(t/2) being an even function of t, the batch kernels of the
+  /// exponential maps use it to work on the squared norm of the increment,
+  /// without sqrt, trigonometric function or branch for small angles.
+  inline double cosHalfPoly(double u)
+  {
+    double p = 1./2432902008176640000;
+    p = p*u + 1./6402373705728000;
+    p = p*u + 1./20922789888000;
+    p = p*u + 1./87178291200;
+    p = p*u + 1./479001600;
+    p = p*u + 1./3628800;
+    p = p*u + 1./40320;
+    p = p*u + 1./720;
+    p = p*u + 1./24;
+    p = p*u + 1./2;
+    return p*u + 1;
+  }
+
+  /// \brief sin(t/2)/(t/2) as a polynomial of u = -(t/2)^2.
+  /// For t < pi, the truncation error is below 1e-18.
+  inline double sincHalfPoly(double u)
+  {
+    double p = 1./51090942171709440000.;
+    p = p*u + 1./121645100408832000;
+    p = p*u + 1./355687428096000;
+    p = p*u + 1./1307674368000;
+    p = p*u + 1./6227020800;
+    p = p*u + 1./39916800;
+    p = p*u + 1./362880;
+    p = p*u + 1./5040;
+    p = p*u + 1./120;
+    p = p*u + 1./6;
+    return p*u + 1;
+  }
+}
+
+#endif //_MANIFOLDS_HALF_ANGLE_H_
@@ -30,14 +30,11 @@ namespace mnf
     F  //full space
   };
 
-  template<int Dr, int Dc> struct ViewReturnType { typedef Eigen::Block<RefMat> Type; };
-  template<int Dr, int Dc> struct ConstViewReturnType { typedef const Eigen::Block<ConstRefMat> Type; };
-  template<int Dc> struct ViewReturnType<F, Dc> { typedef RefMat::ColsBlockXpr Type; };
-  template<int Dc> struct ConstViewReturnType<F, Dc> { typedef ConstRefMat::ConstColsBlockXpr Type; };
-  template<int Dr> struct ViewReturnType<Dr, F> { typedef RefMat::RowsBlockXpr Type; };
-  template<int Dr> struct ConstViewReturnType<Dr, F> { typedef ConstRefMat::ConstRowsBlockXpr Type; };
-  template<> struct ViewReturnType<F, F> { typedef RefMat Type; };
-  template<> struct ConstViewReturnType<F, F> { typedef ConstRefMat Type; };
+  /// \internal The views are returned as Ref and not as Block: a Block keeps a
+  /// reference on the matrix it is taken from, which for getView is a Ref
+  /// passed by value that dies when getView returns.
+  template<int Dr, int Dc> struct ViewReturnType { typedef RefMat Type; };
+  template<int Dr, int Dc> struct ConstViewReturnType { typedef ConstRefMat Type; };
 }
 
 #endif //_MANIFOLDS_VIEW_H_
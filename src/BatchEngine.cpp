@@ -0,0 +1,199 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+
+#include <manifolds/BatchEngine.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/ThreadPool.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  namespace
+  {
+    /// Scratch of the engine for the calling thread. It is distinct from
+    /// ReusableTemporaryMap::threadBuffer(), that the manifolds use for their
+    /// own temporaries during the operations of a job.
+    ReusableTemporaryMap& workerScratch()
+    {
+      thread_local ReusableTemporaryMap scratch;
+      return scratch;
+    }
+  }
+
+  const Index BatchEngine::ChunkDoubles;
+  const Index BatchEngine::MinChunk;
+
+  BatchEngine::BatchEngine(ThreadPool& pool)
+    : pool_(pool)
+  {
+  }
+
+  BatchEngine::BatchEngine()
+    : pool_(ThreadPool::global())
+  {
+  }
+
+  size_t BatchEngine::threadCount() const
+  {
+    return pool_.size();
+  }
+
+  ThreadPool& BatchEngine::pool() const
+  {
+    return pool_;
+  }
+
+  Index BatchEngine::chunkSize(const Manifold& M)
+  {
+    Index r = std::max(M.representationDim(), M.tangentDim());
+    return std::max(MinChunk, ChunkDoubles / std::max(r, Index(1)));
+  }
+
+  void BatchEngine::run(Index n, Index chunk, const Job& job) const
+  {
+    mnf_assert(chunk > 0);
+    pool_.parallelFor(0, n, chunk, [&job](Index b, Index e) { job(b, e, workerScratch()); });
+  }
+
+  void BatchEngine::retractation(PointSet& out, const PointSet& x, const ConstRefMat& v) const
+  {
+    const Manifold& M = x.getManifold();
+    mnf_assert(&out.getManifold() == &M && "out must be a set of points of the same manifold");
+    mnf_assert(out.layout() == x.layout() && "out must have the same layout");
+    out.resize(x.size());
+    RefMat o = out.values();
+    ConstRefMat xv = x.values();
+    if (x.layout() == PointSet::ArrayOfStructures)
+    {
+      mnf_assert(v.rows() == M.tangentDim() && v.cols() == x.size());
+      run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap&)
+      {
+        M.batchRetractation(o.middleCols(b, e - b), xv.middleCols(b, e - b), v.middleCols(b, e - b));
+      });
+    }
+    else
+    {
+      mnf_assert(v.cols() == M.tangentDim() && v.rows() == x.size());
+      run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap&)
+      {
+        M.batchRetractationSoA(o.middleRows(b, e - b), xv.middleRows(b, e - b), v.middleRows(b, e - b));
+      });
+    }
+  }
+
+  void BatchEngine::increment(PointSet& x, const ConstRefMat& v) const
+  {
+    retractation(x, x, v);
+  }
+
+  void BatchEngine::pseudoLog(RefMat out, const PointSet& x, const PointSet& y) const
+  {
+    const Manifold& M = x.getManifold();
+    mnf_assert(y.size() == x.size());
+    mnf_assert(y.layout() == x.layout());
+    ConstRefMat xv = x.values();
+    ConstRefMat yv = y.values();
+    if (x.layout() == PointSet::ArrayOfStructures)
+    {
+      mnf_assert(out.rows() == M.tangentDim() && out.cols() == x.size());
+      run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap&)
+      {
+        for (Index j = b; j < e; ++j)
+          M.pseudoLog(out.col(j), xv.col(j), yv.col(j));
+      });
+    }
+    else
+    {
+      mnf_assert(out.cols() == M.tangentDim() && out.rows() == x.size());
+      Index r = M.representationDim();
+      Index t = M.tangentDim();
+      run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap& scratch)
+      {
+        Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> tmp = scratch.getMap(std::max(r, t), 3);
+        for (Index j = b; j < e; ++j)
+        {
+          tmp.col(0).head(r) = xv.row(j).transpose();
+          tmp.col(1).head(r) = yv.row(j).transpose();
+          M.pseudoLog(tmp.col(2).head(t), tmp.col(0).head(r), tmp.col(1).head(r));
+          out.row(j) = tmp.col(2).head(t).transpose();
+        }
+      });
+    }
+  }
+
+  void BatchEngine::pseudoLog0(RefMat out, const PointSet& x) const
+  {
+    const Manifold& M = x.getManifold();
+    ConstRefMat xv = x.values();
+    if (x.layout() == PointSet::ArrayOfStructures)
+    {
+      mnf_assert(out.rows() == M.tangentDim() && out.cols() == x.size());
+      run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap&)
+      {
+        for (Index j = b; j < e; ++j)
+          M.pseudoLog0(out.col(j), xv.col(j));
+      });
+    }
+    else
+    {
+      mnf_assert(out.cols() == M.tangentDim() && out.rows() == x.size());
+      Index r = M.representationDim();
+      Index t = M.tangentDim();
+      run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap& scratch)
+      {
+        Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> tmp = scratch.getMap(std::max(r, t), 2);
+        for (Index j = b; j < e; ++j)
+        {
+          tmp.col(0).head(r) = xv.row(j).transpose();
+          M.pseudoLog0(tmp.col(1).head(t), tmp.col(0).head(r));
+          out.row(j) = tmp.col(1).head(t).transpose();
+        }
+      });
+    }
+  }
+
+  bool BatchEngine::isInM(const PointSet& x, const double& prec) const
+  {
+    const Manifold& M = x.getManifold();
+    ConstRefMat xv = x.values();
+    bool aos = x.layout() == PointSet::ArrayOfStructures;
+    Index r = M.representationDim();
+    std::atomic<bool> inM(true);
+    run(x.size(), chunkSize(M), [&](Index b, Index e, ReusableTemporaryMap& scratch)
+    {
+      Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> tmp = scratch.getMap(r, 1);
+      for (Index j = b; j < e && inM.load(std::memory_order_relaxed); ++j)
+      {
+        bool ok;
+        if (aos)
+          ok = M.isInM(xv.col(j), prec);
+        else
+        {
+          tmp.col(0) = xv.row(j).transpose();
+          ok = M.isInM(tmp.col(0), prec);
+        }
+        if (!ok)
+          inM.store(false, std::memory_order_relaxed);
+      }
+    });
+    return inM.load();
+  }
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <manifolds/BlockDiagonalMatrix.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  BlockDiagonalMatrix::BlockDiagonalMatrix(Index rows, Index cols)
+    : rows_(rows)
+    , cols_(cols)
+  {
+    mnf_assert(rows >= 0 && cols >= 0 && "Negative size");
+  }
+
+  void BlockDiagonalMatrix::reserve(size_t nBlocks, size_t nCoeffs)
+  {
+    blocks_.reserve(nBlocks);
+    data_.reserve(nCoeffs);
+  }
+
+  Eigen::Map<Eigen::MatrixXd> BlockDiagonalMatrix::addBlock(Index startRow, Index startCol, Index r, Index c)
+  {
+    mnf_assert(startRow >= 0 && startCol >= 0 && r >= 0 && c >= 0);
+    mnf_assert(startRow + r <= rows_ && startCol + c <= cols_ && "Block out of the matrix");
+    Block b = {startRow, startCol, r, c, data_.size(), false};
+    blocks_.push_back(b);
+    data_.resize(data_.size() + static_cast<size_t>(r*c));
+    return Eigen::Map<Eigen::MatrixXd>(data_.data() + b.offset, r, c);
+  }
+
+  void BlockDiagonalMatrix::addIdentityBlock(Index startRow, Index startCol, Index n)
+  {
+    mnf_assert(startRow >= 0 && startCol >= 0 && n >= 0);
+    mnf_assert(startRow + n <= rows_ && startCol + n <= cols_ && "Block out of the matrix");
+    Block b = {startRow, startCol, n, n, data_.size(), true};
+    blocks_.push_back(b);
+  }
+
+  Eigen::MatrixXd BlockDiagonalMatrix::toDense() const
+  {
+    Eigen::MatrixXd out = Eigen::MatrixXd::Zero(rows_, cols_);
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+      const Block& b = blocks_[i];
+      if (b.identity)
+        out.block(b.row, b.col, b.rows, b.cols).setIdentity();
+      else
+        out.block(b.row, b.col, b.rows, b.cols) = block(i);
+    }
+    return out;
+  }
+
+  Eigen::SparseMatrix<double> BlockDiagonalMatrix::toSparse() const
+  {
+    Eigen::SparseMatrix<double> out(rows_, cols_);
+    Eigen::VectorXi nnz = Eigen::VectorXi::Zero(cols_);
+    for (const auto& b : blocks_)
+      nnz.segment(b.col, b.cols).array() += b.identity ? 1 : static_cast<int>(b.rows);
+    out.reserve(nnz);
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+      const Block& b = blocks_[i];
+      if (b.identity)
+      {
+        for (Index j = 0; j < b.cols; ++j)
+          out.insert(b.row + j, b.col + j) = 1;
+        continue;
+      }
+      Eigen::Map<const Eigen::MatrixXd> B = block(i);
+      for (Index j = 0; j < b.cols; ++j)
+        for (Index k = 0; k < b.rows; ++k)
+          out.insert(b.row + k, b.col + j) = B(k, j);
+    }
+    out.makeCompressed();
+    return out;
+  }
+
+  void BlockDiagonalMatrix::applyLeft(RefMat out, const ConstRefMat& in) const
+  {
+    mnf_assert(in.cols() == rows_ && out.rows() == in.rows() && out.cols() == cols_);
+    out.setZero();
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+      const Block& b = blocks_[i];
+      if (b.identity)
+        out.middleCols(b.col, b.cols) += in.middleCols(b.row, b.rows);
+      else
+        out.middleCols(b.col, b.cols).noalias() += in.middleCols(b.row, b.rows) * block(i);
+    }
+  }
+
+  void BlockDiagonalMatrix::applyRight(RefMat out, const ConstRefMat& in) const
+  {
+    mnf_assert(in.rows() == cols_ && out.rows() == rows_ && out.cols() == in.cols());
+    out.setZero();
+    for (size_t i = 0; i < blocks_.size(); ++i)
+    {
+      const Block& b = blocks_[i];
+      if (b.identity)
+        out.middleRows(b.row, b.rows) += in.middleRows(b.col, b.cols);
+      else
+        out.middleRows(b.row, b.rows).noalias() += block(i) * in.middleRows(b.col, b.cols);
+    }
+  }
+
+  Eigen::SparseMatrix<double> BlockDiagonalMatrix::applyLeft(const Eigen::SparseMatrix<double>& in) const
+  {
+    mnf_assert(in.cols() == rows_);
+    return in * toSparse();
+  }
+
+  Eigen::SparseMatrix<double> BlockDiagonalMatrix::applyRight(const Eigen::SparseMatrix<double>& in) const
+  {
+    mnf_assert(in.rows() == cols_);
+    return toSparse() * in;
+  }
+}
@@ -15,16 +15,248 @@
 // manifolds. If not, see
 // <http://www.gnu.org/licenses/>.
 
+
+#include <sstream>
 #include <manifolds/CartesianPower.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/utils.h>
 
 namespace mnf
 {
   CartesianPower::CartesianPower(const Manifold& M, int n)
-    : CartesianProduct()
+    : Manifold(n*M.dim(), n*M.tangentDim(), n*M.representationDim()),
+      manifold_(M),
+      n_(n),
+      r_(M.representationDim()),
+      t_(M.tangentDim()),
+      d_(M.dim())
   {
-    for (int i = 0; i < n; ++i)
-      multiply(M);
+    mnf_assert(n >= 0 && "Negative power");
+    M.lock();
+    if (M.isElementary())
+      name() = M.name() + "^" + std::to_string(n);
+    else
+      name() = "(" + M.name() + ")^" + std::to_string(n);
+  }
+
+  size_t CartesianPower::numberOfSubmanifolds() const
+  {
+    return static_cast<size_t>(n_);
+  }
+
+  const Manifold& CartesianPower::operator()(size_t i) const
+  {
+    mnf_assert(i < numberOfSubmanifolds() && "invalid index");
+    return manifold_;
+  }
+
+  std::string CartesianPower::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    std::stringstream ss;
+    for (Index i = 0; i < n_; ++i)
+    {
+      if (i > 0)
+        ss << std::endl;
+      ss << manifold_.toString(val.segment(i*r_, r_), prefix + "  ", prec);
+    }
+    return ss.str();
   }
-}
 
+  bool CartesianPower::isElementary() const
+  {
+    return false;
+  }
+
+  bool CartesianPower::hasIdentityJacobians() const
+  {
+    return manifold_.hasIdentityJacobians();
+  }
+
+  void CartesianPower::display(std::string prefix) const
+  {
+    if (manifold_.isElementary())
+      std::cout << prefix << name() << std::endl;
+    else
+    {
+      std::cout << prefix << "/----------------------------------"<< std::endl;
+      manifold_.display(prefix + "| ");
+      std::cout << prefix << "\\---------------------------------- ^" << n_ << std::endl;
+    }
+  }
+
+  bool CartesianPower::isInM_(const ConstRefVec& val, const double& prec) const
+  {
+    bool out = true;
+    for (Index i = 0; i < n_ && out; ++i)
+      out = manifold_.isInM_(val.segment(i*r_, r_), prec);
+    return out;
+  }
+
+  void CartesianPower::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.forceOnM_(out.segment(i*r_, r_), in.segment(i*r_, r_));
+  }
+
+  void CartesianPower::createRandomPoint_(RefVec out, double coeff) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.createRandomPoint_(out.segment(i*r_, r_), coeff);
+  }
+
+  void CartesianPower::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    //The n copies of a vector are the columns of a r_ x n_ (resp. t_ x n_)
+    //matrix, so that the whole retractation is one batch operation.
+    Eigen::Map<Eigen::MatrixXd> outMat(out.data(), r_, n_);
+    Eigen::Map<const Eigen::MatrixXd> xMat(x.data(), r_, n_);
+    Eigen::Map<const Eigen::MatrixXd> vMat(v.data(), t_, n_);
+    manifold_.batchRetractation_(outMat, xMat, vMat);
+  }
+
+  void CartesianPower::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    if (out.outerStride() == out.rows() && x.outerStride() == x.rows() && v.outerStride() == v.rows())
+    {
+      Eigen::Map<Eigen::MatrixXd> outMat(out.data(), r_, n_*out.cols());
+      Eigen::Map<const Eigen::MatrixXd> xMat(x.data(), r_, n_*x.cols());
+      Eigen::Map<const Eigen::MatrixXd> vMat(v.data(), t_, n_*v.cols());
+      manifold_.batchRetractation_(outMat, xMat, vMat);
+    }
+    else
+      Manifold::batchRetractation_(out, x, v);
+  }
+
+  void CartesianPower::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.pseudoLog_(out.segment(i*t_, t_), x.segment(i*r_, r_), y.segment(i*r_, r_));
+  }
+
+  void CartesianPower::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.pseudoLog0_(out.segment(i*t_, t_), x.segment(i*r_, r_));
+  }
+
+  void CartesianPower::setZero_(RefVec out) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.setZero_(out.segment(i*r_, r_));
+  }
 
+  Eigen::MatrixXd CartesianPower::diffRetractation_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(representationDim(), tangentDim());
+    J.setZero();
+    if (hasIdentityJacobians())
+      J.setIdentity();
+    else
+    {
+      for (Index i = 0; i < n_; ++i)
+        J.block(i*r_, i*t_, r_, t_) = manifold_.diffRetractation_(x.segment(i*r_, r_));
+    }
+    return J;
+  }
+
+  void CartesianPower::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.applyDiffRetractation_(out.middleCols(i*t_, t_), in.middleCols(i*r_, r_), x.segment(i*r_, r_));
+  }
+
+  Eigen::MatrixXd CartesianPower::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(tangentDim(), representationDim());
+    J.setZero();
+    if (hasIdentityJacobians())
+      J.setIdentity();
+    else
+    {
+      for (Index i = 0; i < n_; ++i)
+        J.block(i*t_, i*r_, t_, r_) = manifold_.diffPseudoLog0_(x.segment(i*r_, r_));
+    }
+    return J;
+  }
+
+  void CartesianPower::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.applyDiffPseudoLog0_(out.middleCols(i*r_, r_), in.middleCols(i*t_, t_), x.segment(i*r_, r_));
+  }
+
+  void CartesianPower::diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const
+  {
+    if (hasIdentityJacobians())
+      J.addIdentityBlock(startR, startT, tangentDim());
+    else
+    {
+      for (Index i = 0; i < n_; ++i)
+        manifold_.diffRetractationBlocks_(J, x.segment(i*r_, r_), startR + i*r_, startT + i*t_);
+    }
+  }
+
+  void CartesianPower::diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const
+  {
+    if (hasIdentityJacobians())
+      J.addIdentityBlock(startT, startR, tangentDim());
+    else
+    {
+      for (Index i = 0; i < n_; ++i)
+        manifold_.diffPseudoLog0Blocks_(J, x.segment(i*r_, r_), startT + i*t_, startR + i*r_);
+    }
+  }
+
+  void CartesianPower::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.applyTransport_(out.middleRows(i*t_, t_), in.middleRows(i*t_, t_),
+                                x.segment(i*r_, r_), v.segment(i*t_, t_));
+  }
+
+  void CartesianPower::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.applyInvTransport_(out.middleCols(i*t_, t_), in.middleCols(i*t_, t_),
+                                   x.segment(i*r_, r_), v.segment(i*t_, t_));
+  }
+
+  void CartesianPower::tangentConstraint_(RefMat out, const ConstRefVec& x) const
+  {
+    Index s = t_ - d_;
+    out.setZero();
+    for (Index i = 0; i < n_; ++i)
+      manifold_.tangentConstraint_(out.block(i*s, i*t_, s, t_), x.segment(i*r_, r_));
+  }
+
+  bool CartesianPower::isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const
+  {
+    bool b = true;
+    for (Index i = 0; i < n_ && b; ++i)
+      b = manifold_.isInTxM_(x.segment(i*r_, r_), v.segment(i*t_, t_), prec);
+    return b;
+  }
+
+  void CartesianPower::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.forceOnTxM_(out.segment(i*t_, t_), in.segment(i*t_, t_), x.segment(i*r_, r_));
+  }
+
+  void CartesianPower::limitMap_(RefVec out) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.limitMap_(out.segment(i*t_, t_));
+  }
+
+  void CartesianPower::getTypicalMagnitude_(RefVec out) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      manifold_.getTypicalMagnitude_(out.segment(i*t_, t_));
+  }
+
+  long CartesianPower::getTypeId() const
+  {
+    return ::utils::hash::computeHash("CartesianPower");
+  }
+}
@@ -22,6 +22,10 @@ namespace mnf
 {
   CartesianProduct::CartesianProduct()
     : Manifold(0,0,0)
+    , identityJacobians_(true)
+    , parallelThreshold_(0)
+    , pool_(0x0)
+    , rowTileSize_(0)
   {
     startIndexT_.push_back(0);
     startIndexR_.push_back(0);
@@ -30,6 +34,10 @@ namespace mnf
 
   CartesianProduct::CartesianProduct(std::initializer_list<Manifold*> m)
     : Manifold(0,0,0)
+    , identityJacobians_(true)
+    , parallelThreshold_(0)
+    , pool_(0x0)
+    , rowTileSize_(0)
   {
     startIndexT_.push_back(0);
     startIndexR_.push_back(0);
@@ -40,6 +48,10 @@ namespace mnf
 
   CartesianProduct::CartesianProduct(const Manifold& m1, const Manifold& m2)
     : Manifold(0,0,0)
+    , identityJacobians_(true)
+    , parallelThreshold_(0)
+    , pool_(0x0)
+    , rowTileSize_(0)
   {
     startIndexT_.push_back(0);
     startIndexR_.push_back(0);
@@ -48,20 +60,25 @@ namespace mnf
     name() = m1.name() + "x" + m2.name();
   }
 
-  bool CartesianProduct::isInM_(const Eigen::VectorXd& val, const double& ) const
+  bool CartesianProduct::isInM_(const ConstRefVec& val, const double& prec) const
   {
-    bool out = true;
-    for (std::size_t i = 0; i<numberOfSubmanifolds(); ++i)
+    checkLeaves();
+    std::atomic<bool> out(true);
+    forEachLeaf([&](const PlanEntry& e)
     {
-      out = out && submanifolds_[i]->isInM(getConstView<R>(val, i));
-    }
+      if (out && !e.m->isInM_(val.segment(e.startR, e.dimR), prec))
+        out = false;
+    });
     return out;
   }
 
   void CartesianProduct::forceOnM_(RefVec out, const ConstRefVec& in) const
   {
-    for (std::size_t i = 0; i<numberOfSubmanifolds(); ++i)
-      submanifolds_[i]->forceOnM(getView<R>(out,i), getConstView<R>(in,i));
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      e.m->forceOnM_(out.segment(e.startR, e.dimR), in.segment(e.startR, e.dimR));
+    });
   }
 
   CartesianProduct& CartesianProduct::multiply(const Manifold& m)
@@ -73,6 +90,25 @@ namespace mnf
     setDimension(dim() + m.dim());
     setTangentDimension(tangentDim() + m.tangentDim());
     setRepresentationDimension(representationDim() + m.representationDim());
+    const CartesianProduct* p = dynamic_cast<const CartesianProduct*>(&m);
+    Index c = plan_.empty() ? 0 : plan_.back().startC + plan_.back().dimC;
+    if (p)
+    {
+      for (auto e : p->plan_)
+      {
+        e.startR += startIndexR_.back();
+        e.startT += startIndexT_.back();
+        e.startC += c;
+        plan_.push_back(e);
+      }
+    }
+    else
+    {
+      PlanEntry e = {&m, startIndexR_.back(), startIndexT_.back(), c,
+                     m.representationDim(), m.tangentDim(), m.tangentDim() - m.dim()};
+      plan_.push_back(e);
+    }
+    identityJacobians_ = identityJacobians_ && m.hasIdentityJacobians();
     submanifolds_.push_back(&m);
     startIndexT_.push_back(startIndexT_.back() + m.tangentDim());
     startIndexR_.push_back(startIndexR_.back() + m.representationDim());
@@ -89,6 +125,33 @@ namespace mnf
     return false;
   }
 
+  bool CartesianProduct::hasIdentityJacobians() const
+  {
+    return identityJacobians_;
+  }
+
+  void CartesianProduct::setParallelThreshold(size_t minLeaves, ThreadPool* pool)
+  {
+    parallelThreshold_ = minLeaves;
+    pool_ = pool;
+  }
+
+  size_t CartesianProduct::parallelThreshold() const
+  {
+    return parallelThreshold_;
+  }
+
+  void CartesianProduct::setRowTileSize(Index rows)
+  {
+    mnf_assert(rows >= 0);
+    rowTileSize_ = rows;
+  }
+
+  Index CartesianProduct::rowTileSize() const
+  {
+    return rowTileSize_;
+  }
+
   void CartesianProduct::display(std::string prefix) const
   {
     for (size_t i = 0; i < submanifolds_.size(); ++i)
@@ -124,149 +187,211 @@ namespace mnf
 
   void CartesianProduct::createRandomPoint_(RefVec out, double coeff) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
-      submanifolds_[i]->createRandomPoint(getView<R>(out, i), coeff);
+    checkLeaves();
+    for (const auto& e : plan_)
+      e.m->createRandomPoint_(out.segment(e.startR, e.dimR), coeff);
   }
 
   void CartesianProduct::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
     {
-      submanifolds_[i]->retractation(getView<R>(out, i),
-                              getConstView<R>(x, i),
-                              getConstView<T>(v, i));
-    }
+      e.m->retractation_(out.segment(e.startR, e.dimR),
+                         x.segment(e.startR, e.dimR),
+                         v.segment(e.startT, e.dimT));
+    });
+  }
+
+  void CartesianProduct::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      e.m->batchRetractation_(out.middleRows(e.startR, e.dimR),
+                              x.middleRows(e.startR, e.dimR),
+                              v.middleRows(e.startT, e.dimT));
+    });
   }
 
   void CartesianProduct::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
     {
-      submanifolds_[i]->pseudoLog(getView<T>(out,i),
-                              getConstView<R>(x, i),
-                              getConstView<R>(y, i));
-    }
+      e.m->pseudoLog_(out.segment(e.startT, e.dimT),
+                      x.segment(e.startR, e.dimR),
+                      y.segment(e.startR, e.dimR));
+    });
   }
 
   void CartesianProduct::pseudoLog0_(RefVec out, const ConstRefVec& x) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
     {
-      submanifolds_[i]->pseudoLog0(getView<T>(out,i),
-                               getConstView<R>(x, i));
-    }
+      e.m->pseudoLog0_(out.segment(e.startT, e.dimT), x.segment(e.startR, e.dimR));
+    });
   }
 
   void CartesianProduct::setZero_(RefVec out) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
-      submanifolds_[i]->setZero(getView<R>(out, i));
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      e.m->setZero_(out.segment(e.startR, e.dimR));
+    });
   }
 
   Eigen::MatrixXd CartesianProduct::diffRetractation_(const ConstRefVec& x ) const
   {
+    checkLeaves();
     Eigen::MatrixXd J(representationDim(),tangentDim());
     J.setZero();
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    forEachLeaf([&](const PlanEntry& e)
     {
-      getView<R, T>(J, i) = submanifolds_[i]->diffRetractation(getConstView<R>(x, i));
-    }
+      if (e.m->hasIdentityJacobians())
+        J.block(e.startR, e.startT, e.dimR, e.dimT).setIdentity();
+      else
+        J.block(e.startR, e.startT, e.dimR, e.dimT) = e.m->diffRetractation_(x.segment(e.startR, e.dimR));
+    });
     return J;
   }
 
   void CartesianProduct::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachTile(in.rows(), [&](Index start, Index rows)
     {
-      submanifolds_[i]->applyDiffRetractation( getView<F, T>(out, i),
-                                      getConstView<F, R>(in, i),
-                                      getConstView<R>(x, i));
-    }
+      forEachLeaf([&](const PlanEntry& e)
+      {
+        e.m->applyDiffRetractation_(out.block(start, e.startT, rows, e.dimT),
+                                    in.block(start, e.startR, rows, e.dimR),
+                                    x.segment(e.startR, e.dimR));
+      });
+    });
   }
 
   Eigen::MatrixXd CartesianProduct::diffPseudoLog0_(const ConstRefVec& x) const
   {
+    checkLeaves();
     Eigen::MatrixXd J(tangentDim(),representationDim());
     J.setZero();
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    forEachLeaf([&](const PlanEntry& e)
     {
-      getView<T, R>(J, i) = submanifolds_[i]->diffPseudoLog0(getConstView<R>(x, i));
-    }
+      if (e.m->hasIdentityJacobians())
+        J.block(e.startT, e.startR, e.dimT, e.dimR).setIdentity();
+      else
+        J.block(e.startT, e.startR, e.dimT, e.dimR) = e.m->diffPseudoLog0_(x.segment(e.startR, e.dimR));
+    });
     return J;
   }
 
   void CartesianProduct::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachTile(in.rows(), [&](Index start, Index rows)
     {
-      submanifolds_[i]->applyDiffPseudoLog0(getView<F,R>(out, i),
-                                        getConstView<F, T>(in, i),
-                                        getConstView<R>(x, i));
-    }
+      forEachLeaf([&](const PlanEntry& e)
+      {
+        e.m->applyDiffPseudoLog0_(out.block(start, e.startR, rows, e.dimR),
+                                  in.block(start, e.startT, rows, e.dimT),
+                                  x.segment(e.startR, e.dimR));
+      });
+    });
+  }
+
+  void CartesianProduct::diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const
+  {
+    checkLeaves();
+    for (const auto& e : plan_)
+      e.m->diffRetractationBlocks_(J, x.segment(e.startR, e.dimR), startR + e.startR, startT + e.startT);
+  }
+
+  void CartesianProduct::diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const
+  {
+    checkLeaves();
+    for (const auto& e : plan_)
+      e.m->diffPseudoLog0Blocks_(J, x.segment(e.startR, e.dimR), startT + e.startT, startR + e.startR);
   }
 
   void CartesianProduct::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
     {
-      submanifolds_[i]->applyTransport(getView<T, F>(out, i),
-                                       getConstView<T, F>(in, i),
-                                       getConstView<R>(x, i),
-                                       getConstView<T>(v, i));
-    }
+      e.m->applyTransport_(out.middleRows(e.startT, e.dimT),
+                           in.middleRows(e.startT, e.dimT),
+                           x.segment(e.startR, e.dimR),
+                           v.segment(e.startT, e.dimT));
+    });
   }
 
   void CartesianProduct::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    checkLeaves();
+    forEachTile(in.rows(), [&](Index start, Index rows)
     {
-      submanifolds_[i]->applyInvTransport(getView<F, T>(out, i),
-                                          getConstView<F, T>(in, i),
-                                          getConstView<R>(x, i),
-                                          getConstView<T>(v, i));
-    }
+      forEachLeaf([&](const PlanEntry& e)
+      {
+        e.m->applyInvTransport_(out.block(start, e.startT, rows, e.dimT),
+                                in.block(start, e.startT, rows, e.dimT),
+                                x.segment(e.startR, e.dimR),
+                                v.segment(e.startT, e.dimT));
+      });
+    });
   }
 
   void CartesianProduct::tangentConstraint_(RefMat out, const ConstRefVec& x) const
   {
-    Index k = 0;
+    checkLeaves();
     out.setZero();
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
+    forEachLeaf([&](const PlanEntry& e)
     {
-      Index s = submanifolds_[i]->tangentDim() - submanifolds_[i]->dim();
-      auto Ci = getView<F, T>(out, i);
-      submanifolds_[i]->tangentConstraint(Ci.middleRows(k,s),
-                                          getConstView<R>(x, i));
-      k += s;
-    }
+      e.m->tangentConstraint_(out.block(e.startC, e.startT, e.dimC, e.dimT),
+                              x.segment(e.startR, e.dimR));
+    });
   }
 
   bool CartesianProduct::isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const
   {
-    bool b = true;
-    for (size_t i = 0; i < submanifolds_.size() && b; ++i)
-      b = submanifolds_[i]->isInTxM(getConstView<R>(x, i), getConstView<T>(v, i), prec);
+    checkLeaves();
+    std::atomic<bool> b(true);
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      if (b && !e.m->isInTxM_(x.segment(e.startR, e.dimR), v.segment(e.startT, e.dimT), prec))
+        b = false;
+    });
     return b;
   }
 
   void CartesianProduct::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
-      submanifolds_[i]->forceOnTxM(getView<T>(out, i),
-                                   getConstView<T>(in, i),
-                                   getConstView<R>(x, i));
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      e.m->forceOnTxM_(out.segment(e.startT, e.dimT),
+                       in.segment(e.startT, e.dimT),
+                       x.segment(e.startR, e.dimR));
+    });
   }
 
   void CartesianProduct::limitMap_(RefVec out) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
-      submanifolds_[i]->limitMap(getView<T>(out, i));
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      e.m->limitMap_(out.segment(e.startT, e.dimT));
+    });
   }
 
   void CartesianProduct::getTypicalMagnitude_(RefVec out) const
   {
-    for (size_t i = 0; i < submanifolds_.size(); ++i)
-      submanifolds_[i]->getTypicalMagnitude(getView<T>(out, i));
+    checkLeaves();
+    forEachLeaf([&](const PlanEntry& e)
+    {
+      e.m->getTypicalMagnitude_(out.segment(e.startT, e.dimT));
+    });
   }
 
   long CartesianProduct::getTypeId() const
@@ -16,11 +16,14 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <iostream>
+#include <algorithm>
+#include <limits>
 #include <boost/math/special_functions/sinc.hpp>
 #include <Eigen/Dense>
 #include <Eigen/LU>
 #include <manifolds/defs.h>
 #include <manifolds/ExpMapMatrix.h>
+#include <manifolds/halfAngle.h>
 #include <manifolds/mnf_assert.h>
 
 namespace utility
@@ -62,6 +65,154 @@ namespace mnf
     toMat3(out.data()) = (toConstMat3(x.data()))*E;
   }
 
+  namespace
+  {
+    /// Number of rotations processed together by the batch kernels
+    const int batchChunk = 8;
+
+    /// Index of coefficient i of element j in an array where the elements are
+    /// stored as columns (AoS) or where each coefficient has its own plane (SoA).
+    /// s is the outer stride of the array.
+    template<bool soa>
+    inline Index at(Index i, Index j, Index s)
+    {
+      return soa ? i*s + j : j*s + i;
+    }
+
+    /// Computes E_j = exp(v_j), or E_j = x_j*exp(v_j) if x is not null, for
+    /// the n elements of the arrays. The inner loops of a chunk are branch-free
+    /// and vectorized. out can be equal to x.
+    template<bool soa>
+    MNF_TARGET_CLONES
+    void expMapMatrixKernel(double* out, Index so, const double* x, Index sx,
+                            const double* v, Index sv, Index n)
+    {
+      double w[3][batchChunk], e[9][batchChunk], xm[9][batchChunk], xe[9][batchChunk];
+      for (Index j0 = 0; j0 < n; j0 += batchChunk)
+      {
+        const int m = static_cast<int>(std::min<Index>(batchChunk, n - j0));
+        for (int i = 0; i < 3; ++i)
+          for (int k = 0; k < batchChunk; ++k)
+            w[i][k] = v[at<soa>(i, j0 + std::min(k, m - 1), sv)];
+        for (int k = 0; k < batchChunk; ++k)
+        {
+          const double x2 = w[0][k]*w[0][k], y2 = w[1][k]*w[1][k], z2 = w[2][k]*w[2][k];
+          const double u = -0.25*(x2 + y2 + z2);
+          const double sh = sincHalfPoly(u);
+          const double s = sh*cosHalfPoly(u); // sin(t)/t
+          const double c = 0.5*sh*sh;         // (1-cos(t))/t^2
+          const double cxy = c*w[0][k]*w[1][k], cxz = c*w[0][k]*w[2][k], cyz = c*w[1][k]*w[2][k];
+          e[0][k] = 1 - c*(y2 + z2);
+          e[1][k] = s*w[2][k] + cxy;
+          e[2][k] = -s*w[1][k] + cxz;
+          e[3][k] = -s*w[2][k] + cxy;
+          e[4][k] = 1 - c*(x2 + z2);
+          e[5][k] = s*w[0][k] + cyz;
+          e[6][k] = s*w[1][k] + cxz;
+          e[7][k] = -s*w[0][k] + cyz;
+          e[8][k] = 1 - c*(x2 + y2);
+        }
+        double (*res)[batchChunk] = e;
+        if (x)
+        {
+          for (int i = 0; i < 9; ++i)
+            for (int k = 0; k < batchChunk; ++k)
+              xm[i][k] = x[at<soa>(i, j0 + std::min(k, m - 1), sx)];
+          for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+              for (int k = 0; k < batchChunk; ++k)
+                xe[r+3*c][k] = xm[r][k]*e[3*c][k] + xm[r+3][k]*e[1+3*c][k] + xm[r+6][k]*e[2+3*c][k];
+          res = xe;
+        }
+        for (int i = 0; i < 9; ++i)
+          for (int k = 0; k < m; ++k)
+            out[at<soa>(i, j0 + k, so)] = res[i][k];
+      }
+    }
+
+    /// Computes out_j = log(R_j) for the n elements of the arrays.
+    /// The angle is computed with atan2(sin(t), cos(t)), which is accurate for
+    /// small angles and does not need a special case. Only this call is not
+    /// vectorized.
+    template<bool soa>
+    MNF_TARGET_CLONES
+    void logMapMatrixKernel(double* out, Index so, const double* R, Index sR, Index n)
+    {
+      double r[9][batchChunk], w[3][batchChunk], sn[batchChunk], cs[batchChunk], f[batchChunk];
+      for (Index j0 = 0; j0 < n; j0 += batchChunk)
+      {
+        const int m = static_cast<int>(std::min<Index>(batchChunk, n - j0));
+        for (int i = 0; i < 9; ++i)
+          for (int k = 0; k < batchChunk; ++k)
+            r[i][k] = R[at<soa>(i, j0 + std::min(k, m - 1), sR)];
+        for (int k = 0; k < batchChunk; ++k)
+        {
+          w[0][k] = (r[5][k] - r[7][k])/2;
+          w[1][k] = (r[6][k] - r[2][k])/2;
+          w[2][k] = (r[1][k] - r[3][k])/2;
+          sn[k] = std::sqrt(w[0][k]*w[0][k] + w[1][k]*w[1][k] + w[2][k]*w[2][k]);
+          cs[k] = (r[0][k] + r[4][k] + r[8][k] - 1)/2;
+        }
+        for (int k = 0; k < batchChunk; ++k)
+          f[k] = std::atan2(sn[k], cs[k]);
+        for (int k = 0; k < batchChunk; ++k)
+          f[k] /= std::max(sn[k], std::numeric_limits<double>::min());
+        for (int i = 0; i < 3; ++i)
+          for (int k = 0; k < m; ++k)
+            out[at<soa>(i, j0 + k, so)] = f[k]*w[i][k];
+      }
+    }
+
+    inline bool isValidIncrement(const ConstRefMat& v, bool soa)
+    {
+      if (v.size() == 0)
+        return true;
+      if (soa)
+        return v.rowwise().squaredNorm().maxCoeff() < M_PI*M_PI;
+      return v.colwise().squaredNorm().maxCoeff() < M_PI*M_PI;
+    }
+  }
+
+  void ExpMapMatrix::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v)
+  {
+    mnf_assert(isValidIncrement(v, false) && "Increment for expMap must be of norm at most pi");
+    expMapMatrixKernel<false>(out.data(), out.outerStride(), x.data(), x.outerStride(),
+                              v.data(), v.outerStride(), v.cols());
+  }
+
+  void ExpMapMatrix::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v)
+  {
+    mnf_assert(isValidIncrement(v, true) && "Increment for expMap must be of norm at most pi");
+    expMapMatrixKernel<true>(out.data(), out.outerStride(), x.data(), x.outerStride(),
+                             v.data(), v.outerStride(), v.rows());
+  }
+
+  void ExpMapMatrix::batchExponential(RefMat out, const ConstRefMat& v)
+  {
+    mnf_assert(out.rows() == OutputDim_ && v.rows() == InputDim_ && out.cols() == v.cols());
+    mnf_assert(isValidIncrement(v, false) && "Increment for expMap must be of norm at most pi");
+    expMapMatrixKernel<false>(out.data(), out.outerStride(), 0x0, 0, v.data(), v.outerStride(), v.cols());
+  }
+
+  void ExpMapMatrix::batchLogarithm(RefMat out, const ConstRefMat& R)
+  {
+    mnf_assert(out.rows() == InputDim_ && R.rows() == OutputDim_ && out.cols() == R.cols());
+    logMapMatrixKernel<false>(out.data(), out.outerStride(), R.data(), R.outerStride(), R.cols());
+  }
+
+  void ExpMapMatrix::batchExponentialSoA(RefMat out, const ConstRefMat& v)
+  {
+    mnf_assert(out.cols() == OutputDim_ && v.cols() == InputDim_ && out.rows() == v.rows());
+    mnf_assert(isValidIncrement(v, true) && "Increment for expMap must be of norm at most pi");
+    expMapMatrixKernel<true>(out.data(), out.outerStride(), 0x0, 0, v.data(), v.outerStride(), v.rows());
+  }
+
+  void ExpMapMatrix::batchLogarithmSoA(RefMat out, const ConstRefMat& R)
+  {
+    mnf_assert(out.cols() == InputDim_ && R.cols() == OutputDim_ && out.rows() == R.rows());
+    logMapMatrixKernel<true>(out.data(), out.outerStride(), R.data(), R.outerStride(), R.rows());
+  }
+
   void ExpMapMatrix::exponential(OutputType& E, const ConstRefVec& v)
   {
     mnf_assert(v.size() == 3 && "Increment for expMap must be of size 3");
@@ -124,7 +275,12 @@ namespace mnf
     toMat3(out.data()) = Eigen::Matrix3d::Identity();
   }
 
-  bool ExpMapMatrix::isInM_(const Eigen::VectorXd& val, const double& )
+  Eigen::Matrix3d ExpMapMatrix::rotationMatrix(const ConstRefVec& x)
+  {
+    return toConstMat3(x.data());
+  }
+
+  bool ExpMapMatrix::isInM_(const ConstRefVec& val, const double& )
   {
     bool out(val.size()==9);
     toConstMat3 valMat(val.data());
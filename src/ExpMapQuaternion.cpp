@@ -16,11 +16,13 @@
 // <http://www.gnu.org/licenses/>.
 
 #include <iostream>
+#include <algorithm>
 #include <boost/math/special_functions/sinc.hpp>
 #include <Eigen/Dense>
 #include <Eigen/Geometry>
 #include <manifolds/defs.h>
 #include <manifolds/ExpMapQuaternion.h>
+#include <manifolds/halfAngle.h>
 #include <manifolds/mnf_assert.h>
 
 namespace mnf
@@ -36,6 +38,97 @@ namespace mnf
     toQuat(out.data()) = (toConstQuat(x.data()))*(toConstQuat(q.data())); //out = x*exp(v)
   }
 
+  namespace
+  {
+    /// Number of quaternions processed together by the batch kernel
+    const int batchChunk = 8;
+
+    /// Index of coefficient i of element j in an array where the elements are
+    /// stored as columns (AoS) or where each coefficient has its own plane (SoA).
+    /// s is the outer stride of the array.
+    template<bool soa>
+    inline Index at(Index i, Index j, Index s)
+    {
+      return soa ? i*s + j : j*s + i;
+    }
+
+    /// Computes q_j = exp(v_j), or q_j = x_j*exp(v_j) if x is not null, for
+    /// the n elements of the arrays. s* are the outer strides of the arrays.
+    /// The inner loops of a chunk are branch-free and vectorized.
+    /// q can be equal to x.
+    template<bool soa>
+    MNF_TARGET_CLONES
+    void expMapQuaternionKernel(double* q, Index sq, const double* x, Index sx,
+                                const double* v, Index sv, Index n)
+    {
+      double vx[batchChunk], vy[batchChunk], vz[batchChunk];
+      double qx[batchChunk], qy[batchChunk], qz[batchChunk], qw[batchChunk];
+      double xx[batchChunk], xy[batchChunk], xz[batchChunk], xw[batchChunk];
+      for (Index j0 = 0; j0 < n; j0 += batchChunk)
+      {
+        const int m = static_cast<int>(std::min<Index>(batchChunk, n - j0));
+        for (int k = 0; k < batchChunk; ++k)
+        {
+          const Index j = j0 + std::min(k, m - 1);
+          vx[k] = v[at<soa>(0, j, sv)]; vy[k] = v[at<soa>(1, j, sv)]; vz[k] = v[at<soa>(2, j, sv)];
+        }
+        for (int k = 0; k < batchChunk; ++k)
+        {
+          const double u = -0.25*(vx[k]*vx[k] + vy[k]*vy[k] + vz[k]*vz[k]);
+          const double s = 0.5*sincHalfPoly(u);
+          qw[k] = cosHalfPoly(u);
+          qx[k] = s*vx[k];
+          qy[k] = s*vy[k];
+          qz[k] = s*vz[k];
+        }
+        if (x)
+        {
+          for (int k = 0; k < batchChunk; ++k)
+          {
+            const Index j = j0 + std::min(k, m - 1);
+            xx[k] = x[at<soa>(0, j, sx)]; xy[k] = x[at<soa>(1, j, sx)];
+            xz[k] = x[at<soa>(2, j, sx)]; xw[k] = x[at<soa>(3, j, sx)];
+          }
+          for (int k = 0; k < batchChunk; ++k)
+          {
+            const double a = xw[k]*qx[k] + xx[k]*qw[k] + xy[k]*qz[k] - xz[k]*qy[k];
+            const double b = xw[k]*qy[k] - xx[k]*qz[k] + xy[k]*qw[k] + xz[k]*qx[k];
+            const double c = xw[k]*qz[k] + xx[k]*qy[k] - xy[k]*qx[k] + xz[k]*qw[k];
+            const double d = xw[k]*qw[k] - xx[k]*qx[k] - xy[k]*qy[k] - xz[k]*qz[k];
+            qx[k] = a; qy[k] = b; qz[k] = c; qw[k] = d;
+          }
+        }
+        for (int k = 0; k < m; ++k)
+        {
+          const Index j = j0 + k;
+          q[at<soa>(0, j, sq)] = qx[k]; q[at<soa>(1, j, sq)] = qy[k];
+          q[at<soa>(2, j, sq)] = qz[k]; q[at<soa>(3, j, sq)] = qw[k];
+        }
+      }
+    }
+  }
+
+  void ExpMapQuaternion::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v)
+  {
+    mnf_assert((v.cols() == 0 || v.colwise().squaredNorm().maxCoeff() < M_PI*M_PI) && "Increment for expMap must be of norm at most pi");
+    expMapQuaternionKernel<false>(out.data(), out.outerStride(), x.data(), x.outerStride(),
+                                  v.data(), v.outerStride(), v.cols());
+  }
+
+  void ExpMapQuaternion::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v)
+  {
+    mnf_assert((v.rows() == 0 || v.rowwise().squaredNorm().maxCoeff() < M_PI*M_PI) && "Increment for expMap must be of norm at most pi");
+    expMapQuaternionKernel<true>(out.data(), out.outerStride(), x.data(), x.outerStride(),
+                                 v.data(), v.outerStride(), v.rows());
+  }
+
+  void ExpMapQuaternion::batchExponential(RefMat out, const ConstRefMat& v)
+  {
+    mnf_assert(out.rows() == OutputDim_ && v.rows() == InputDim_ && out.cols() == v.cols());
+    mnf_assert((v.cols() == 0 || v.colwise().squaredNorm().maxCoeff() < M_PI*M_PI) && "Increment for expMap must be of norm at most pi");
+    expMapQuaternionKernel<false>(out.data(), out.outerStride(), 0x0, 0, v.data(), v.outerStride(), v.cols());
+  }
+
   void ExpMapQuaternion::exponential(OutputType& q, const ConstRefVec& v)
   {
     mnf_assert(v.size() == 3 && "Increment for expMap must be of size 3");
@@ -88,7 +181,12 @@ namespace mnf
     toQuat(out.data()).setIdentity();
   }
 
-  bool ExpMapQuaternion::isInM_(const Eigen::VectorXd& val, const double& )
+  Eigen::Matrix3d ExpMapQuaternion::rotationMatrix(const ConstRefVec& x)
+  {
+    return toConstQuat(x.data()).toRotationMatrix();
+  }
+
+  bool ExpMapQuaternion::isInM_(const ConstRefVec& val, const double& )
   {
     bool out(val.size()==4);
     double norm = toConstQuat(val.data()).norm();
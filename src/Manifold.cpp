@@ -15,30 +15,76 @@
 // manifolds. If not, see
 // <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <stdexcept>
 #include <manifolds/Manifold.h>
+#include <manifolds/ReusableTemporaryMap.h>
+#include <manifolds/ThreadPool.h>
 #include <manifolds/mnf_assert.h>
 
 namespace mnf
 {
-  long Manifold::manifoldCounter_ = 0;
+  std::atomic<long> Manifold::manifoldCounter_(0);
 
   Manifold::Manifold(Index dimension, Index tangentDimension, Index representationDimension)
     : dimension_(dimension)
     , tangentDim_(tangentDimension)
     , representationDim_(representationDimension)
     , lock_(false)
+    , rowParallelThreshold_(0)
+    , rowPool_(0x0)
   {
     mnf_assert(0 <= dimension && "Negative dimension not accepted");
     mnf_assert(dimension <= tangentDimension);
     mnf_assert(tangentDimension <= representationDimension);
-    this->instanceId_ = manifoldCounter_++;
+    this->instanceId_ = manifoldCounter_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Manifold::Manifold(const Manifold& other)
+    : RefCounter()
+    , ValidManifold()
+    , name_(other.name_)
+    , dimension_(other.dimension_)
+    , tangentDim_(other.tangentDim_)
+    , representationDim_(other.representationDim_)
+    , instanceId_(other.instanceId_)
+    , lock_(other.lock_.load())
+    , rowParallelThreshold_(other.rowParallelThreshold_)
+    , rowPool_(other.rowPool_)
+  {
+  }
+
+  Manifold& Manifold::operator=(const Manifold& other)
+  {
+    name_ = other.name_;
+    dimension_ = other.dimension_;
+    tangentDim_ = other.tangentDim_;
+    representationDim_ = other.representationDim_;
+    instanceId_ = other.instanceId_;
+    lock_.store(other.lock_.load());
+    rowParallelThreshold_ = other.rowParallelThreshold_;
+    rowPool_ = other.rowPool_;
+    return *this;
   }
 
   Manifold::~Manifold()
   {
   }
 
+  template<typename F>
+  void Manifold::forEachRowTile(Index rows, const F& f) const
+  {
+    if (rowParallelThreshold_ == 0 || rows < rowParallelThreshold_)
+    {
+      f(0, rows);
+      return;
+    }
+    ThreadPool& pool = rowPool_ ? *rowPool_ : ThreadPool::global();
+    Index tiles = 4 * static_cast<Index>(pool.size());
+    Index grain = std::max<Index>(1, (rows + tiles - 1) / tiles);
+    pool.parallelFor(0, rows, grain, [&f](Index b, Index e) { f(b, e - b); });
+  }
+
   Point Manifold::createPoint() const
   {
     mnf_assert(isValid() || seeMessageAbove());
@@ -60,7 +106,7 @@ namespace mnf
     }
   }
 
-  bool Manifold::isInM(const Eigen::VectorXd& val, const double& prec) const
+  bool Manifold::isInM(const ConstRefVec& val, const double& prec) const
   {
     mnf_assert(isValid() || seeMessageAbove());
     mnf_assert(val.size() == representationDim());
@@ -80,18 +126,57 @@ namespace mnf
   {
     mnf_assert(isValid() || seeMessageAbove());
     lock();
-    Eigen::VectorXd id(representationDim_);
-    setZero(id);
-    return Point(*this, id);
+    Point p(*this);
+    setZero(p.value());
+    return p;
   }
 
   Point Manifold::createRandomPoint(double coeff) const
   {
     mnf_assert(isValid() || seeMessageAbove());
     lock();
-    Eigen::VectorXd val(representationDim_);
-    createRandomPoint(val, coeff);
-    return Point(*this, val);
+    Point p(*this);
+    createRandomPoint(p.value(), coeff);
+    return p;
+  }
+
+  Point Manifold::createPoint(PointArena& arena) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    lock();
+    return Point(*this, &arena);
+  }
+
+  Point Manifold::createPoint(const ConstRefVec& val, PointArena& arena) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    if (isInM(val))
+    {
+      lock();
+      return Point(*this, val, &arena);
+    }
+    else
+    {
+      throw std::runtime_error("Bad Point Initialization");
+    }
+  }
+
+  Point Manifold::getZero(PointArena& arena) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    lock();
+    Point p(*this, &arena);
+    setZero(p.value());
+    return p;
+  }
+
+  Point Manifold::createRandomPoint(PointArena& arena, double coeff) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    lock();
+    Point p(*this, &arena);
+    createRandomPoint(p.value(), coeff);
+    return p;
   }
 
   void Manifold::createRandomPoint(RefVec out, double coeff) const
@@ -132,6 +217,64 @@ namespace mnf
     mnf_assert(isInTxM(x, v) && "Wrong tangent vector provided to retractation");
     retractation_(out, x, v);
   }
+
+  void Manifold::batchRetractation(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    mnf_assert(out.rows() == representationDim_);
+    mnf_assert(x.rows() == representationDim_);
+    mnf_assert(v.rows() == tangentDim_);
+    mnf_assert(out.cols() == x.cols());
+    mnf_assert(v.cols() == x.cols());
+#ifndef NDEBUG
+    for (Index j = 0; j < x.cols(); ++j)
+      mnf_assert(isInTxM(x.col(j), v.col(j)) && "Wrong tangent vector provided to batchRetractation");
+#endif
+    batchRetractation_(out, x, v);
+  }
+
+  void Manifold::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    for (Index j = 0; j < x.cols(); ++j)
+      retractation_(out.col(j), x.col(j), v.col(j));
+  }
+
+  void Manifold::batchRetractationSoA(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    mnf_assert(out.cols() == representationDim_);
+    mnf_assert(x.cols() == representationDim_);
+    mnf_assert(v.cols() == tangentDim_);
+    mnf_assert(out.rows() == x.rows());
+    mnf_assert(v.rows() == x.rows());
+#ifndef NDEBUG
+    {
+      //the rows are copied in the thread buffer to be checked as vectors
+      Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> buffer = ReusableTemporaryMap::threadBuffer().getMap(representationDim_ + tangentDim_, 1);
+      for (Index j = 0; j < x.rows(); ++j)
+      {
+        buffer.col(0).head(representationDim_) = x.row(j).transpose();
+        buffer.col(0).tail(tangentDim_) = v.row(j).transpose();
+        mnf_assert(isInTxM(buffer.col(0).head(representationDim_), buffer.col(0).tail(tangentDim_))
+                   && "Wrong tangent vector provided to batchRetractationSoA");
+      }
+    }
+#endif
+    batchRetractationSoA_(out, x, v);
+  }
+
+  void Manifold::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    Eigen::VectorXd xj(representationDim_), vj(tangentDim_);
+    for (Index j = 0; j < x.rows(); ++j)
+    {
+      xj = x.row(j).transpose();
+      vj = v.row(j).transpose();
+      retractation_(xj, xj, vj);
+      out.row(j) = xj.transpose();
+    }
+  }
+
   //void Manifold::retractation(RefVec out, const Point& x, const ConstRefVec& v) const
   //{
   //  retractation( out, x.value(), v);
@@ -210,7 +353,32 @@ namespace mnf
     mnf_assert(out.cols() == tangentDim_);
     mnf_assert(in.rows() == out.rows());
     mnf_assert(x.size() == representationDim_);
-    applyDiffRetractation_(out, in, x);
+    forEachRowTile(in.rows(), [&](Index start, Index rows)
+    {
+      applyDiffRetractation_(out.middleRows(start, rows), in.middleRows(start, rows), x);
+    });
+  }
+
+  bool Manifold::hasIdentityJacobians() const
+  {
+    return false;
+  }
+
+  BlockDiagonalMatrix Manifold::diffRetractationBlocks(const ConstRefVec& x) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    mnf_assert(x.size() == representationDim_);
+    BlockDiagonalMatrix J(representationDim_, tangentDim_);
+    diffRetractationBlocks_(J, x, 0, 0);
+    return J;
+  }
+
+  void Manifold::diffRetractationBlocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startR, Index startT) const
+  {
+    if (hasIdentityJacobians())
+      J.addIdentityBlock(startR, startT, tangentDim_);
+    else
+      J.addBlock(startR, startT, representationDim_, tangentDim_) = diffRetractation_(x);
   }
 
   Eigen::MatrixXd Manifold::diffPseudoLog0(const ConstRefVec& x) const
@@ -228,7 +396,39 @@ namespace mnf
     mnf_assert(in.cols() == tangentDim_);
     mnf_assert(in.rows() == out.rows());
     mnf_assert(x.size() == representationDim_);
-    applyDiffPseudoLog0_(out, in, x);
+    forEachRowTile(in.rows(), [&](Index start, Index rows)
+    {
+      applyDiffPseudoLog0_(out.middleRows(start, rows), in.middleRows(start, rows), x);
+    });
+  }
+
+  void Manifold::setRowParallelThreshold(Index minRows, ThreadPool* pool)
+  {
+    mnf_assert(minRows >= 0);
+    rowParallelThreshold_ = minRows;
+    rowPool_ = pool;
+  }
+
+  Index Manifold::rowParallelThreshold() const
+  {
+    return rowParallelThreshold_;
+  }
+
+  BlockDiagonalMatrix Manifold::diffPseudoLog0Blocks(const ConstRefVec& x) const
+  {
+    mnf_assert(isValid() || seeMessageAbove());
+    mnf_assert(x.size() == representationDim_);
+    BlockDiagonalMatrix J(tangentDim_, representationDim_);
+    diffPseudoLog0Blocks_(J, x, 0, 0);
+    return J;
+  }
+
+  void Manifold::diffPseudoLog0Blocks_(BlockDiagonalMatrix& J, const ConstRefVec& x, Index startT, Index startR) const
+  {
+    if (hasIdentityJacobians())
+      J.addIdentityBlock(startT, startR, tangentDim_);
+    else
+      J.addBlock(startT, startR, tangentDim_, representationDim_) = diffPseudoLog0_(x);
   }
 
   void Manifold::applyTransport(
@@ -338,12 +538,12 @@ namespace mnf
 
   void Manifold::lock() const
   {
-    lock_ = true;
+    lock_.store(true, std::memory_order_release);
   }
 
   void Manifold::testLock() const
   {
-    if (lock_)
+    if (lock_.load(std::memory_order_acquire))
       throw std::runtime_error("Either a point or a compound manifold is relying on this manifold, you can't modify it anymore.");
   }
 
@@ -0,0 +1,276 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <limits>
+#include <sstream>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include <manifolds/Oblique.h>
+#include <manifolds/ReusableTemporaryMap.h>
+#include <manifolds/Sn.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  Oblique::Oblique(Index k, Index n)
+    : Manifold(n*(k - 1), k*n, k*n)
+    , k_(k)
+    , n_(n)
+  {
+    mnf_assert(k > 1 && n > 0 && "Oblique(k, n) requires k > 1 and n > 0");
+    name() = "OB(" + std::to_string(k) + ", " + std::to_string(n) + ")";
+    setTypicalMagnitude(M_PI);
+  }
+
+  Oblique::Oblique(Index k, Index n, double magnitude)
+    : Manifold(n*(k - 1), k*n, k*n)
+    , k_(k)
+    , n_(n)
+  {
+    mnf_assert(k > 1 && n > 0 && "Oblique(k, n) requires k > 1 and n > 0");
+    name() = "OB(" + std::to_string(k) + ", " + std::to_string(n) + ")";
+    setTypicalMagnitude(magnitude);
+  }
+
+  Index Oblique::vectorDim() const
+  {
+    return k_;
+  }
+
+  Index Oblique::numberOfVectors() const
+  {
+    return n_;
+  }
+
+  Oblique::MatMap Oblique::mat(RefVec v) const
+  {
+    return MatMap(v.data(), k_, n_);
+  }
+
+  Oblique::ConstMatMap Oblique::mat(const ConstRefVec& v) const
+  {
+    return ConstMatMap(v.data(), k_, n_);
+  }
+
+  bool Oblique::isInM_(const ConstRefVec& val, const double& prec) const
+  {
+    ConstMatMap X = mat(val);
+    for (Index j = 0; j < n_; ++j)
+    {
+      if (fabs(X.col(j).norm() - 1.0) >= prec)
+        return false;
+    }
+    return true;
+  }
+
+  void Oblique::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    MatMap O = mat(out);
+    ConstMatMap I = mat(in);
+    for (Index j = 0; j < n_; ++j)
+      O.col(j) = I.col(j)/I.col(j).norm();
+  }
+
+  size_t Oblique::numberOfSubmanifolds() const
+  {
+    return 1;
+  }
+
+  bool Oblique::isElementary() const
+  {
+    return true;
+  }
+
+  const Manifold& Oblique::operator()(size_t i) const
+  {
+    mnf_assert(i < 1 && "invalid index");
+    return *this;
+  }
+
+  std::string Oblique::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    std::string matPrefix = prefix + '[';
+    Eigen::IOFormat CleanFmt(prec, 0, ", ", "\n", matPrefix, "]");
+    std::stringstream ss;
+    ss << mat(val).format(CleanFmt);
+    return ss.str();
+  }
+
+  void Oblique::createRandomPoint_(RefVec out, double) const
+  {
+    out.setRandom();
+    forceOnM_(out, out);
+  }
+
+  void Oblique::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    Sn::retractCols(mat(out), mat(x), mat(v));
+  }
+
+  void Oblique::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    const Index N = x.cols();
+    const Index r = representationDim();
+    if (out.outerStride() == r && x.outerStride() == r && v.outerStride() == r)
+    {
+      //the N points form a single k x nN matrix
+      Sn::retractCols(MatMap(out.data(), k_, n_*N), ConstMatMap(x.data(), k_, n_*N), ConstMatMap(v.data(), k_, n_*N));
+    }
+    else
+    {
+      for (Index j = 0; j < N; ++j)
+        retractation_(out.col(j), x.col(j), v.col(j));
+    }
+  }
+
+  void Oblique::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    for (Index i = 0; i < n_; ++i)
+      Sn::retractRows(out.middleCols(i*k_, k_), x.middleCols(i*k_, k_), v.middleCols(i*k_, k_));
+  }
+
+  void Oblique::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    Sn::logCols(mat(out), mat(x), mat(y));
+  }
+
+  void Oblique::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    Sn::log0Cols(mat(out), mat(x));
+  }
+
+  void Oblique::setZero_(RefVec out) const
+  {
+    MatMap O = mat(out);
+    O.setZero();
+    O.row(0).setOnes();
+  }
+
+  Eigen::MatrixXd Oblique::diffRetractation_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(Eigen::MatrixXd::Zero(k_*n_, k_*n_));
+    ConstMatMap X = mat(x);
+    for (Index i = 0; i < n_; ++i)
+    {
+      J.block(i*k_, i*k_, k_, k_).noalias() = -X.col(i)*X.col(i).transpose();
+      J.block(i*k_, i*k_, k_, k_).diagonal().array() += 1;
+    }
+    return J;
+  }
+
+  void Oblique::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    //out_i = in_i - (in_i x_i) x_i^T for each block of k columns
+    ConstMatMap X = mat(x);
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> a = ReusableTemporaryMap::threadBuffer().getMap(in.rows(), n_);
+    for (Index i = 0; i < n_; ++i)
+      a.col(i).noalias() = in.middleCols(i*k_, k_)*X.col(i);
+    out = in;
+    for (Index i = 0; i < n_; ++i)
+      out.middleCols(i*k_, k_).noalias() -= a.col(i)*X.col(i).transpose();
+  }
+
+  Eigen::MatrixXd Oblique::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(Eigen::MatrixXd::Zero(k_*n_, k_*n_));
+    ConstMatMap X = mat(x);
+    for (Index i = 0; i < n_; ++i)
+      Sn::diffLog0(J.block(i*k_, i*k_, k_, k_), X.col(i));
+    return J;
+  }
+
+  void Oblique::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    ConstMatMap X = mat(x);
+    for (Index i = 0; i < n_; ++i)
+      Sn::applyDiffLog0(out.middleCols(i*k_, k_), in.middleCols(i*k_, k_), X.col(i));
+  }
+
+  void Oblique::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    //projection of each block of k rows of in on the tangent space at the
+    //corresponding column of y = x+v
+    const Index r = k_*n_;
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> buffer = ReusableTemporaryMap::threadBuffer().getMap(r + in.cols(), 1);
+    MatMap Y(buffer.data(), k_, n_);
+    Sn::retractCols(Y, mat(x), mat(v));
+    for (Index i = 0; i < n_; ++i)
+    {
+      buffer.col(0).tail(in.cols()).noalias() = in.middleRows(i*k_, k_).transpose()*Y.col(i);
+      out.middleRows(i*k_, k_) = in.middleRows(i*k_, k_);
+      out.middleRows(i*k_, k_).noalias() -= Y.col(i)*buffer.col(0).tail(in.cols()).transpose();
+    }
+  }
+
+  void Oblique::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec&) const
+  {
+    applyDiffRetractation_(out, in, x);
+  }
+
+  void Oblique::tangentConstraint_(RefMat out, const ConstRefVec& x) const
+  {
+    ConstMatMap X = mat(x);
+    out.setZero();
+    for (Index i = 0; i < n_; ++i)
+      out.block(i, i*k_, 1, k_) = X.col(i).transpose();
+  }
+
+  bool Oblique::isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const
+  {
+    ConstMatMap X = mat(x);
+    ConstMatMap V = mat(v);
+    for (Index i = 0; i < n_; ++i)
+    {
+      if (fabs(X.col(i).dot(V.col(i))) >= prec)
+        return false;
+    }
+    return true;
+  }
+
+  void Oblique::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
+  {
+    Sn::projCols(mat(out), mat(in), mat(x));
+  }
+
+  void Oblique::limitMap_(RefVec out) const
+  {
+    out.setConstant(std::numeric_limits<double>::infinity());
+  }
+
+  void Oblique::getTypicalMagnitude_(RefVec out) const
+  {
+    out = typicalMagnitude_;
+  }
+
+  void Oblique::setTypicalMagnitude(double magnitude)
+  {
+    typicalMagnitude_.setConstant(tangentDim(), magnitude);
+  }
+
+  void Oblique::setTypicalMagnitude(const ConstRefVec& out)
+  {
+    mnf_assert(out.size() == tangentDim());
+    typicalMagnitude_ = out;
+  }
+
+  long Oblique::getTypeId() const
+  {
+    long typeId = ::utils::hash::computeHash("Oblique");
+    return typeId;
+  }
+}
@@ -15,8 +15,12 @@
 // manifolds. If not, see
 // <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <iostream>
+#include <new>
+#include <utility>
 #include <manifolds/Point.h>
+#include <manifolds/PointArena.h>
 #include <manifolds/Manifold.h>
 #include <manifolds/mnf_assert.h>
 
@@ -106,34 +110,118 @@ namespace mnf
 
 
 
-  PointMemory::PointMemory(Index size) : mem_(size) {}
+  PointMemory::PointMemory(Index size, PointArena* arena)
+    : mem_((arena || size <= InlineSize) ? 0 : size)
+    , arena_(arena)
+    , data_(arena ? arena->allocate(size) : (size <= InlineSize ? inline_ : mem_.data()))
+    , size_(size)
+  {
+    if (arena_)
+      arena_->registerPoint();
+  }
 
-  PointMemory::PointMemory(const ConstRefVec& v) : mem_(v) {}
+  PointMemory::PointMemory(const ConstRefVec& v, PointArena* arena)
+    : PointMemory(v.size(), arena)
+  {
+    getMem() = v;
+  }
 
-  Eigen::VectorXd& PointMemory::getMem()
+  PointMemory::PointMemory(PointMemory&& other)
+    : mem_()
+    , arena_(other.arena_)
+    , data_(other.data_)
+    , size_(other.size_)
   {
-    mnf_assert(mem_.size() > 0);
-    return mem_;
+    if (arena_)
+    {
+      //other keeps its arena, but not the memory, so that assigning to it
+      //does not write in this point
+      arena_->registerPoint();
+      other.data_ = 0x0;
+      other.size_ = 0;
+    }
+    else if (size_ <= InlineSize)
+    {
+      std::copy(other.data_, other.data_ + size_, inline_);
+      data_ = inline_;
+    }
+    else
+    {
+      mem_.swap(other.mem_);
+      other.data_ = 0x0;
+      other.size_ = 0;
+    }
   }
 
+  PointMemory::~PointMemory()
+  {
+    if (arena_)
+      arena_->unregisterPoint();
+  }
 
+  RefVec PointMemory::getMem()
+  {
+    return Eigen::Map<Eigen::VectorXd>(data_, size_);
+  }
+
+  bool PointMemory::swapMem(PointMemory& other)
+  {
+    bool onHeap = !arena_ && (size_ > InlineSize || size_ == 0);
+    bool otherOnHeap = !other.arena_ && other.size_ > InlineSize;
+    if (!onHeap || !otherOnHeap)
+      return false;
+    mem_.swap(other.mem_);
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return true;
+  }
 
-  Point::Point(const Manifold& M)
-    : PointMemory(M.representationDim())
+  void PointMemory::ensureMem(Index size)
+  {
+    if (size_ > 0)
+      return;
+    if (arena_)
+      data_ = arena_->allocate(size);
+    else if (size > InlineSize)
+    {
+      mem_.resize(size);
+      data_ = mem_.data();
+    }
+    else
+      data_ = inline_;
+    size_ = size;
+  }
+
+  PointArena* PointMemory::getArena() const
+  {
+    return arena_;
+  }
+
+
+
+  Point::Point(const Manifold& M, PointArena* arena)
+    : PointMemory(M.representationDim(), arena)
     , SubPoint(M, getMem())
   {
   }
 
-  Point::Point(const Manifold& M, const ConstRefVec& val)
-    : PointMemory(val)
+  Point::Point(const Manifold& M, const ConstRefVec& val, PointArena* arena)
+    : PointMemory(val, arena)
     , SubPoint(M, getMem())
   {
   }
 
   Point::Point(const Point& other)
-    : PointMemory(other.value())
+    : PointMemory(other.value(), other.getArena())
+    , SubPoint(other.getManifold(), getMem())
+  {
+  }
+
+  Point::Point(Point&& other)
+    : PointMemory(std::move(other))
     , SubPoint(other.getManifold(), getMem())
   {
+    other.reseat();
   }
 
   Point::Point(const ConstSubPoint& other)
@@ -142,17 +230,23 @@ namespace mnf
   {
   }
 
-  Point& Point::increment(const ConstRefVec& v)
+  Point& Point::increment(const ConstRefVec& v) &
   {
     manifold_.retractation(value_, value_, v);
     return *this;
   }
 
+  Point&& Point::increment(const ConstRefVec& v) &&
+  {
+    manifold_.retractation(value_, value_, v);
+    return std::move(*this);
+  }
+
   Point Point::retractation(const ConstRefVec& v) const
   {
-    Eigen::VectorXd out(manifold_.representationDim());
-    manifold_.retractation(out, this->value_, v);
-    return manifold_.createPoint(out);
+    Point out(manifold_, getArena());
+    manifold_.retractation(out.value(), this->value_, v);
+    return out;
   }
   void Point::retractation(RefVec out, const ConstRefVec& v) const
   {
@@ -194,13 +288,39 @@ namespace mnf
   {
     mnf_assert(this->manifold_.dim() == x.getManifold().dim());
     mnf_assert(this->manifold_.representationDim() == x.getManifold().representationDim());
+    ensureMem(x.value().size());
+    reseat();
     this->value_ = x.value();
     return *this;
   }
+
+  Point & Point::operator=(Point&& x)
+  {
+    mnf_assert(this->manifold_.dim() == x.getManifold().dim());
+    mnf_assert(this->manifold_.representationDim() == x.getManifold().representationDim());
+    if (this != &x && swapMem(x))
+    {
+      reseat();
+      x.reseat();
+      return *this;
+    }
+    return *this = static_cast<const Point&>(x);
+  }
+
+  void Point::reseat()
+  {
+    RefVec mem = getMem();
+    new (&value_) RefVec(mem);
+  }
   
   Point operator+(const Point& x, const ConstRefVec& v)
   {
-    return x.getManifold().createPoint(x.value()).increment(v);
+    return x.retractation(v);
+  }
+
+  Point operator+(Point&& x, const ConstRefVec& v)
+  {
+    return std::move(x).increment(v);
   }
 
   Eigen::VectorXd operator-(const Point& x, const Point& y)
@@ -0,0 +1,116 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <manifolds/PointArena.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  namespace
+  {
+    //Allocations are rounded to this number of doubles to keep the values
+    //of the points aligned
+    const size_t alignment = 4;
+  }
+
+  PointArena::PointArena(size_t chunkSize)
+    : chunkSize_(chunkSize)
+    , current_(0)
+    , offset_(0)
+    , usedBefore_(0)
+#ifndef NDEBUG
+    , count_(0)
+#endif
+  {
+    mnf_assert(chunkSize > 0 && "chunkSize must be at least one");
+  }
+
+  PointArena::~PointArena() NOEXCEPT(false)
+  {
+    testEmpty();
+    for (auto& c : chunks_)
+      allocator_.deallocate(c.data, c.size);
+  }
+
+  double* PointArena::allocate(Index n)
+  {
+    mnf_assert(n >= 0);
+    size_t s = (static_cast<size_t>(n) + alignment - 1) / alignment * alignment;
+    while (current_ < chunks_.size() && offset_ + s > chunks_[current_].size)
+    {
+      usedBefore_ += offset_;
+      offset_ = 0;
+      ++current_;
+    }
+    if (current_ == chunks_.size())
+    {
+      Chunk c = {0x0, std::max(s, chunkSize_)};
+      c.data = allocator_.allocate(c.size);
+      chunks_.push_back(c);
+    }
+    double* p = chunks_[current_].data + offset_;
+    offset_ += s;
+    return p;
+  }
+
+  void PointArena::clear()
+  {
+    testEmpty();
+    current_ = 0;
+    offset_ = 0;
+    usedBefore_ = 0;
+  }
+
+  void PointArena::release()
+  {
+    clear();
+    for (auto& c : chunks_)
+      allocator_.deallocate(c.data, c.size);
+    chunks_.clear();
+  }
+
+  size_t PointArena::capacity() const
+  {
+    size_t s = 0;
+    for (const auto& c : chunks_)
+      s += c.size;
+    return s;
+  }
+
+  void PointArena::registerPoint()
+  {
+#ifndef NDEBUG
+    ++count_;
+#endif
+  }
+
+  void PointArena::unregisterPoint()
+  {
+#ifndef NDEBUG
+    mnf_assert(count_ > 0);
+    --count_;
+#endif
+  }
+
+  void PointArena::testEmpty() const
+  {
+#ifndef NDEBUG
+    mnf_assert(count_ == 0 && "Some points still use the memory of this arena");
+#endif
+  }
+}
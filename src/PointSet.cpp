@@ -0,0 +1,308 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <manifolds/PointSet.h>
+#include <manifolds/Manifold.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  PointSet::PointSet(const Manifold& M, Index n, Layout layout)
+    : manifold_(M)
+    , layout_(layout)
+    , mem_(layout == ArrayOfStructures ? M.representationDim() : 0,
+           layout == ArrayOfStructures ? 0 : M.representationDim())
+    , size_(0)
+  {
+    mnf_assert(M.isValid() || M.seeMessageAbove());
+    mnf_assert(n >= 0);
+    M.lock();
+    manifold_.incrementRefCounter();
+    resize(n);
+  }
+
+  PointSet::PointSet(const PointSet& other)
+    : manifold_(other.manifold_)
+    , layout_(other.layout_)
+    , mem_(other.values())
+    , size_(other.size_)
+  {
+    manifold_.incrementRefCounter();
+  }
+
+  PointSet::~PointSet()
+  {
+    manifold_.decrementRefCounter();
+  }
+
+  PointSet& PointSet::operator=(const PointSet& other)
+  {
+    mnf_assert(manifold_.dim() == other.manifold_.dim());
+    mnf_assert(manifold_.representationDim() == other.manifold_.representationDim());
+    if (this != &other)
+    {
+      if (layout_ != other.layout_)
+      {
+        size_ = 0;
+        setLayout(other.layout_);
+      }
+      reserve(other.size_);
+      size_ = other.size_;
+      values() = other.values();
+    }
+    return *this;
+  }
+
+  PointSet::Layout PointSet::layout() const
+  {
+    return layout_;
+  }
+
+  void PointSet::setLayout(Layout layout)
+  {
+    if (layout == layout_)
+      return;
+    Eigen::MatrixXd mem = values().transpose();
+    mem_.swap(mem);
+    layout_ = layout;
+  }
+
+  Index PointSet::size() const
+  {
+    return size_;
+  }
+
+  Index PointSet::capacity() const
+  {
+    return isAoS() ? mem_.cols() : mem_.rows();
+  }
+
+  bool PointSet::empty() const
+  {
+    return size_ == 0;
+  }
+
+  void PointSet::resize(Index n)
+  {
+    mnf_assert(n >= 0);
+    reserve(n);
+    if (isAoS())
+    {
+      for (Index j = size_; j < n; ++j)
+        manifold_.setZero(mem_.col(j));
+    }
+    else if (n > size_)
+    {
+      Eigen::VectorXd zero(manifold_.representationDim());
+      manifold_.setZero(zero);
+      mem_.middleRows(size_, n - size_).rowwise() = zero.transpose();
+    }
+    size_ = n;
+  }
+
+  void PointSet::reserve(Index n)
+  {
+    if (n <= capacity())
+      return;
+    if (isAoS())
+    {
+      Eigen::MatrixXd mem(mem_.rows(), n);
+      mem.leftCols(size_) = mem_.leftCols(size_);
+      mem_.swap(mem);
+    }
+    else
+    {
+      Eigen::MatrixXd mem(n, mem_.cols());
+      mem.topRows(size_) = mem_.topRows(size_);
+      mem_.swap(mem);
+    }
+  }
+
+  void PointSet::clear()
+  {
+    size_ = 0;
+  }
+
+  void PointSet::push_back(const ConstRefVec& val)
+  {
+    mnf_assert(manifold_.isInM(val) && "Wrong value for a point of this manifold");
+    if (size_ == capacity())
+      reserve(std::max<Index>(1, 2 * capacity()));
+    if (isAoS())
+      mem_.col(size_) = val;
+    else
+      mem_.row(size_) = val.transpose();
+    ++size_;
+  }
+
+  SubPoint PointSet::operator[](Index i)
+  {
+    mnf_assert(isAoS() && "Points of a StructureOfArrays set are not contiguous, use getPoint");
+    mnf_assert(0 <= i && i < size_);
+    return SubPoint(manifold_, mem_.col(i));
+  }
+
+  ConstSubPoint PointSet::operator[](Index i) const
+  {
+    mnf_assert(isAoS() && "Points of a StructureOfArrays set are not contiguous, use getPoint");
+    mnf_assert(0 <= i && i < size_);
+    return ConstSubPoint(manifold_, mem_.col(i));
+  }
+
+  Point PointSet::getPoint(Index i) const
+  {
+    mnf_assert(0 <= i && i < size_);
+    if (isAoS())
+      return manifold_.createPoint(mem_.col(i));
+    Eigen::VectorXd val = mem_.row(i).transpose();
+    return manifold_.createPoint(val);
+  }
+
+  RefMat PointSet::values()
+  {
+    if (isAoS())
+      return mem_.leftCols(size_);
+    return mem_.topRows(size_);
+  }
+
+  ConstRefMat PointSet::values() const
+  {
+    if (isAoS())
+      return mem_.leftCols(size_);
+    return mem_.topRows(size_);
+  }
+
+  PointSet::iterator PointSet::begin()
+  {
+    return iterator(this, 0);
+  }
+
+  PointSet::iterator PointSet::end()
+  {
+    return iterator(this, size_);
+  }
+
+  PointSet::const_iterator PointSet::begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  PointSet::const_iterator PointSet::end() const
+  {
+    return const_iterator(this, size_);
+  }
+
+  const Manifold& PointSet::getManifold() const
+  {
+    return manifold_;
+  }
+
+  PointSet& PointSet::increment(const ConstRefMat& v)
+  {
+    if (isAoS())
+      manifold_.batchRetractation(values(), values(), v);
+    else
+      manifold_.batchRetractationSoA(values(), values(), v);
+    return *this;
+  }
+
+  void PointSet::retractation(PointSet& out, const ConstRefMat& v) const
+  {
+    mnf_assert(&out.manifold_ == &manifold_ && "out must be a set of points of the same manifold");
+    mnf_assert(out.layout_ == layout_ && "out must have the same layout");
+    out.reserve(size_);
+    out.size_ = size_;
+    if (isAoS())
+      manifold_.batchRetractation(out.values(), values(), v);
+    else
+      manifold_.batchRetractationSoA(out.values(), values(), v);
+  }
+
+  void PointSet::pseudoLog(RefMat out, const PointSet& y) const
+  {
+    mnf_assert(y.size_ == size_);
+    mnf_assert(y.layout_ == layout_);
+    if (isAoS())
+    {
+      mnf_assert(out.rows() == manifold_.tangentDim() && out.cols() == size_);
+      for (Index j = 0; j < size_; ++j)
+        manifold_.pseudoLog(out.col(j), mem_.col(j), y.mem_.col(j));
+    }
+    else
+    {
+      mnf_assert(out.cols() == manifold_.tangentDim() && out.rows() == size_);
+      Eigen::VectorXd xj(manifold_.representationDim()), yj(manifold_.representationDim());
+      Eigen::VectorXd outj(manifold_.tangentDim());
+      for (Index j = 0; j < size_; ++j)
+      {
+        xj = mem_.row(j).transpose();
+        yj = y.mem_.row(j).transpose();
+        manifold_.pseudoLog(outj, xj, yj);
+        out.row(j) = outj.transpose();
+      }
+    }
+  }
+
+  void PointSet::pseudoLog0(RefMat out) const
+  {
+    if (isAoS())
+    {
+      mnf_assert(out.rows() == manifold_.tangentDim() && out.cols() == size_);
+      for (Index j = 0; j < size_; ++j)
+        manifold_.pseudoLog0(out.col(j), mem_.col(j));
+    }
+    else
+    {
+      mnf_assert(out.cols() == manifold_.tangentDim() && out.rows() == size_);
+      Eigen::VectorXd xj(manifold_.representationDim());
+      Eigen::VectorXd outj(manifold_.tangentDim());
+      for (Index j = 0; j < size_; ++j)
+      {
+        xj = mem_.row(j).transpose();
+        manifold_.pseudoLog0(outj, xj);
+        out.row(j) = outj.transpose();
+      }
+    }
+  }
+
+  bool PointSet::isInM(const double& prec) const
+  {
+    if (isAoS())
+    {
+      for (Index j = 0; j < size_; ++j)
+      {
+        if (!manifold_.isInM(mem_.col(j), prec))
+          return false;
+      }
+      return true;
+    }
+    Eigen::VectorXd xj(manifold_.representationDim());
+    for (Index j = 0; j < size_; ++j)
+    {
+      xj = mem_.row(j).transpose();
+      if (!manifold_.isInM(xj, prec))
+        return false;
+    }
+    return true;
+  }
+
+  bool PointSet::isAoS() const
+  {
+    return layout_ == ArrayOfStructures;
+  }
+}
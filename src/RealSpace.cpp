@@ -22,6 +22,17 @@
 
 namespace mnf
 {
+  namespace
+  {
+    //The Jacobians being the identity, the apply methods are a copy that can
+    //be skipped when the caller passes the same memory as input and output.
+    void copyIfNotAliased(RefMat out, const ConstRefMat& in)
+    {
+      if (out.data() != in.data() || out.outerStride() != in.outerStride())
+        out = in;
+    }
+  }
+
   RealSpace::RealSpace(Index n)
     : Manifold(n, n, n)
   {
@@ -48,7 +59,7 @@ namespace mnf
     setTypicalMagnitude (magnitude);
   }
 
-  bool RealSpace::isInM_(const Eigen::VectorXd& val , const double& ) const
+  bool RealSpace::isInM_(const ConstRefVec& val , const double& ) const
   {
     bool out( dim() == val.size());
     return out;
@@ -94,6 +105,16 @@ namespace mnf
     out = x + v;
   }
 
+  void RealSpace::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    out = x + v;
+  }
+
+  void RealSpace::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    out = x + v;
+  }
+
   void RealSpace::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
   {
     out = y - x;
@@ -109,6 +130,11 @@ namespace mnf
     out.setZero();
   }
 
+  bool RealSpace::hasIdentityJacobians() const
+  {
+    return true;
+  }
+
   Eigen::MatrixXd RealSpace::diffRetractation_(const ConstRefVec& ) const
   {
     return Eigen::MatrixXd::Identity(representationDim(),dim());
@@ -116,7 +142,7 @@ namespace mnf
 
   void RealSpace::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& ) const
   {
-    out = in;
+    copyIfNotAliased(out, in);
   }
 
   Eigen::MatrixXd RealSpace::diffPseudoLog0_(const ConstRefVec&) const
@@ -126,7 +152,7 @@ namespace mnf
 
   void RealSpace::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& ) const
   {
-    out = in;
+    copyIfNotAliased(out, in);
   }
 
   void RealSpace::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec&, const ConstRefVec& ) const
@@ -41,6 +41,12 @@ namespace mnf
     allocator_.deallocate(buffer_, size_);
   }
 
+  ReusableTemporaryMap& ReusableTemporaryMap::threadBuffer()
+  {
+    thread_local ReusableTemporaryMap buffer;
+    return buffer;
+  }
+
   void ReusableTemporaryMap::allocate_(size_t size)
   {
     mnf_assert(buffer_ == 0x0);
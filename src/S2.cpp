@@ -45,7 +45,7 @@ namespace mnf
     setTypicalMagnitude (magnitude);
   }
 
-  bool S2::isInM_(const Eigen::VectorXd& val , const double& prec) const
+  bool S2::isInM_(const ConstRefVec& val , const double& prec) const
   {
     bool out(fabs(val.lpNorm<2>() - 1.0) < prec);
     return out;
@@ -93,6 +93,31 @@ namespace mnf
     out = sum/sum.lpNorm<2>();
   }
 
+  void S2::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    Eigen::Vector3d sum;
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      sum = x.col(j) + v.col(j);
+      out.col(j) = sum/sum.norm();
+    }
+  }
+
+  void S2::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    //one plane per coordinate: the loop over the points is vectorized
+    for (Index j = 0; j < x.rows(); ++j)
+    {
+      const double a = x(j, 0) + v(j, 0);
+      const double b = x(j, 1) + v(j, 1);
+      const double c = x(j, 2) + v(j, 2);
+      const double s = 1/sqrt(a*a + b*b + c*c);
+      out(j, 0) = s*a;
+      out(j, 1) = s*b;
+      out(j, 2) = s*c;
+    }
+  }
+
   void S2::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
   {
     logarithm(out, x, y);
@@ -0,0 +1,102 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <cmath>
+#include <Eigen/Geometry>
+#include <manifolds/SE3.h>
+
+namespace mnf
+{
+  const double SE3Algebra::prec = 0.1;
+
+  namespace
+  {
+    //Coefficients of V and its inverse as functions of t2 = theta^2. Below
+    //prec, their Taylor expansions are used: the closed forms suffer from
+    //cancellations, the worst one being for dD/(theta dtheta).
+
+    /// (1-cos(theta))/theta^2
+    double coeffB(double t2)
+    {
+      if (t2 < SE3Algebra::prec)
+        return 1./2 + t2*(-1./24 + t2*(1./720 + t2*(-1./40320 + t2/3628800)));
+      return (1 - std::cos(std::sqrt(t2)))/t2;
+    }
+
+    /// (theta-sin(theta))/theta^3
+    double coeffC(double t2)
+    {
+      if (t2 < SE3Algebra::prec)
+        return 1./6 + t2*(-1./120 + t2*(1./5040 + t2*(-1./362880 + t2/39916800)));
+      double t = std::sqrt(t2);
+      return (t - std::sin(t))/(t2*t);
+    }
+
+    /// 1/theta^2 - cot(theta/2)/(2 theta)
+    double coeffD(double t2)
+    {
+      if (t2 < SE3Algebra::prec)
+        return 1./12 + t2*(1./720 + t2*(1./30240 + t2*(1./1209600 + t2/47900160)));
+      double t = std::sqrt(t2);
+      return 1/t2 - 1/(2*t*std::tan(t/2));
+    }
+
+    /// dD/dtheta / theta
+    double coeffDD(double t2)
+    {
+      if (t2 < SE3Algebra::prec)
+        return 1./360 + t2*(1./7560 + t2*(1./201600 + t2/5987520));
+      double t = std::sqrt(t2);
+      double dD = -2/(t2*t) + 1/(2*t) + (std::sin(t) + t*std::cos(t))/(2*t2*(1 - std::cos(t)));
+      return dD/t;
+    }
+  }
+
+  Eigen::Matrix3d SE3Algebra::hat(const Eigen::Vector3d& w)
+  {
+    Eigen::Matrix3d W;
+    W <<     0, -w.z(),  w.y(),
+         w.z(),      0, -w.x(),
+        -w.y(),  w.x(),      0;
+    return W;
+  }
+
+  Eigen::Matrix3d SE3Algebra::leftJacobian(const Eigen::Vector3d& w)
+  {
+    double t2 = w.squaredNorm();
+    Eigen::Matrix3d W = hat(w);
+    return Eigen::Matrix3d::Identity() + coeffB(t2)*W + coeffC(t2)*W*W;
+  }
+
+  Eigen::Matrix3d SE3Algebra::invLeftJacobian(const Eigen::Vector3d& w)
+  {
+    double t2 = w.squaredNorm();
+    Eigen::Matrix3d W = hat(w);
+    return Eigen::Matrix3d::Identity() - 0.5*W + coeffD(t2)*W*W;
+  }
+
+  Eigen::Matrix3d SE3Algebra::diffInvLeftJacobian(const Eigen::Vector3d& w, const Eigen::Vector3d& t)
+  {
+    //V^-1 t = t - w x t/2 + D w x (w x t), with w x (w x t) = (w.t) w - |w|^2 t
+    double t2 = w.squaredNorm();
+    Eigen::Vector3d wwt = w.cross(w.cross(t));
+    Eigen::Matrix3d J = 0.5*hat(t);
+    J += coeffD(t2)*(w.dot(t)*Eigen::Matrix3d::Identity() + w*t.transpose() - 2*t*w.transpose());
+    J += coeffDD(t2)*wwt*w.transpose();
+    return J;
+  }
+}
@@ -0,0 +1,325 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <limits>
+#include <sstream>
+#include <math.h>
+
+#include <manifolds/SPD.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  SPD::SPD(Index n)
+    : Manifold(n*(n + 1)/2, n*(n + 1)/2, n*(n + 1)/2)
+    , n_(n)
+  {
+    mnf_assert(n > 0 && "SPD(n) requires n > 0");
+    name() = "SPD(" + std::to_string(n) + ")";
+    setTypicalMagnitude(1.0);
+  }
+
+  SPD::SPD(Index n, double magnitude)
+    : Manifold(n*(n + 1)/2, n*(n + 1)/2, n*(n + 1)/2)
+    , n_(n)
+  {
+    mnf_assert(n > 0 && "SPD(n) requires n > 0");
+    name() = "SPD(" + std::to_string(n) + ")";
+    setTypicalMagnitude(magnitude);
+  }
+
+  Index SPD::matrixSize() const
+  {
+    return n_;
+  }
+
+  Index SPD::packedIndex(Index i, Index j) const
+  {
+    mnf_assert(j <= i && i < n_ && "(i, j) must be in the lower part");
+    return j*n_ - j*(j - 1)/2 + i - j;
+  }
+
+  void SPD::toMatrix(RefMat out, const ConstRefVec& x) const
+  {
+    mnf_assert(out.rows() == n_ && out.cols() == n_);
+    mnf_assert(x.size() == representationDim());
+    for (Index j = 0; j < n_; ++j)
+    {
+      for (Index i = j; i < n_; ++i)
+      {
+        double s = 0;
+        for (Index k = 0; k <= j; ++k)
+          s += x[packedIndex(i, k)]*x[packedIndex(j, k)];
+        out(i, j) = s;
+        out(j, i) = s;
+      }
+    }
+  }
+
+  bool SPD::fromMatrix(RefVec out, const ConstRefMat& S) const
+  {
+    mnf_assert(S.rows() == n_ && S.cols() == n_);
+    mnf_assert(out.size() == representationDim());
+    //left-looking Cholesky decomposition, written directly in packed form
+    for (Index j = 0; j < n_; ++j)
+    {
+      double d = S(j, j);
+      for (Index k = 0; k < j; ++k)
+        d -= out[packedIndex(j, k)]*out[packedIndex(j, k)];
+      if (!(d > 0))
+        return false;
+      double ljj = sqrt(d);
+      out[packedIndex(j, j)] = ljj;
+      for (Index i = j + 1; i < n_; ++i)
+      {
+        double s = S(i, j);
+        for (Index k = 0; k < j; ++k)
+          s -= out[packedIndex(i, k)]*out[packedIndex(j, k)];
+        out[packedIndex(i, j)] = s/ljj;
+      }
+    }
+    return true;
+  }
+
+  double SPD::distance(const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    mnf_assert(x.size() == representationDim());
+    mnf_assert(y.size() == representationDim());
+    double d2 = 0;
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      double ld = log(y[d]/x[d]);
+      d2 += ld*ld + (y.segment(d + 1, n_ - j - 1) - x.segment(d + 1, n_ - j - 1)).squaredNorm();
+    }
+    return sqrt(d2);
+  }
+
+  bool SPD::isInM_(const ConstRefVec& val, const double& ) const
+  {
+    for (Index j = 0; j < n_; ++j)
+    {
+      if (!(val[packedIndex(j, j)] > 0))
+        return false;
+    }
+    return true;
+  }
+
+  void SPD::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    //Changing the sign of a column of L does not change LL^T. A zero diagonal
+    //element is replaced by the machine epsilon.
+    out = in;
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      if (out[d] < 0)
+        out.segment(d, n_ - j) *= -1;
+      else if (!(out[d] > 0))
+        out[d] = std::numeric_limits<double>::epsilon();
+    }
+  }
+
+  size_t SPD::numberOfSubmanifolds() const
+  {
+    return 1;
+  }
+
+  bool SPD::isElementary() const
+  {
+    return true;
+  }
+
+  const Manifold& SPD::operator()(size_t i) const
+  {
+    mnf_assert(i < 1 && "invalid index");
+    return *this;
+  }
+
+  std::string SPD::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    Eigen::MatrixXd S(n_, n_);
+    toMatrix(S, val);
+    std::string matPrefix = prefix + '[';
+    Eigen::IOFormat CleanFmt(prec, 0, ", ", "\n", matPrefix, "]");
+    std::stringstream ss;
+    ss << S.format(CleanFmt);
+    return ss.str();
+  }
+
+  void SPD::createRandomPoint_(RefVec out, double coeff) const
+  {
+    out = coeff*Eigen::VectorXd::Random(representationDim());
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out[d] = exp(out[d]);
+    }
+  }
+
+  void SPD::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out[d] = x[d]*exp(v[d]/x[d]);
+      out.segment(d + 1, n_ - j - 1) = x.segment(d + 1, n_ - j - 1) + v.segment(d + 1, n_ - j - 1);
+    }
+  }
+
+  void SPD::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    //one row of coefficients at a time across all the points
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out.row(d) = x.row(d).array()*(v.row(d).array()/x.row(d).array()).exp();
+      out.middleRows(d + 1, n_ - j - 1) = x.middleRows(d + 1, n_ - j - 1) + v.middleRows(d + 1, n_ - j - 1);
+    }
+  }
+
+  void SPD::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out.col(d) = x.col(d).array()*(v.col(d).array()/x.col(d).array()).exp();
+      out.middleCols(d + 1, n_ - j - 1) = x.middleCols(d + 1, n_ - j - 1) + v.middleCols(d + 1, n_ - j - 1);
+    }
+  }
+
+  void SPD::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out[d] = x[d]*log(y[d]/x[d]);
+      out.segment(d + 1, n_ - j - 1) = y.segment(d + 1, n_ - j - 1) - x.segment(d + 1, n_ - j - 1);
+    }
+  }
+
+  void SPD::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    out = x;
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out[d] = log(x[d]);
+    }
+  }
+
+  void SPD::setZero_(RefVec out) const
+  {
+    out.setZero();
+    for (Index j = 0; j < n_; ++j)
+      out[packedIndex(j, j)] = 1;
+  }
+
+  Eigen::MatrixXd SPD::diffRetractation_(const ConstRefVec& ) const
+  {
+    return Eigen::MatrixXd::Identity(representationDim(), tangentDim());
+  }
+
+  void SPD::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& ) const
+  {
+    out = in;
+  }
+
+  Eigen::MatrixXd SPD::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(Eigen::MatrixXd::Identity(tangentDim(), representationDim()));
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      J(d, d) = 1/x[d];
+    }
+    return J;
+  }
+
+  void SPD::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    out = in;
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out.col(d) /= x[d];
+    }
+  }
+
+  void SPD::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    //the parallel transport from x to y = x+v scales the diagonal by y_jj/x_jj
+    out = in;
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out.row(d) *= exp(v[d]/x[d]);
+    }
+  }
+
+  void SPD::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    out = in;
+    for (Index j = 0; j < n_; ++j)
+    {
+      Index d = packedIndex(j, j);
+      out.col(d) *= exp(-v[d]/x[d]);
+    }
+  }
+
+  void SPD::tangentConstraint_(RefMat, const ConstRefVec&) const
+  {
+    //matrix is 0xt, no need to fill it.
+  }
+
+  bool SPD::isInTxM_(const ConstRefVec&, const ConstRefVec&, const double&) const
+  {
+    return true;
+  }
+
+  void SPD::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec&) const
+  {
+    out = in;
+  }
+
+  void SPD::limitMap_(RefVec out) const
+  {
+    out.setConstant(std::numeric_limits<double>::infinity());
+  }
+
+  void SPD::getTypicalMagnitude_(RefVec out) const
+  {
+    out = typicalMagnitude_;
+  }
+
+  void SPD::setTypicalMagnitude(double magnitude)
+  {
+    typicalMagnitude_.setConstant(tangentDim(), magnitude);
+  }
+
+  void SPD::setTypicalMagnitude(const ConstRefVec& out)
+  {
+    mnf_assert(out.size() == tangentDim());
+    typicalMagnitude_ = out;
+  }
+
+  long SPD::getTypeId() const
+  {
+    long typeId = ::utils::hash::computeHash("SPD");
+    return typeId;
+  }
+}
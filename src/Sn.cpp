@@ -0,0 +1,351 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include <manifolds/Sn.h>
+#include <manifolds/ReusableTemporaryMap.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  namespace
+  {
+    /// Number of points processed together by the structure-of-arrays kernel
+    const Index batchChunk = 64;
+
+    /// For y = c x + p, with p orthogonal to x and s = |p|, Log_x(y) = f p
+    /// with f = atan2(s, c)/s. Also computes g = (df/ds)/s, used by the
+    /// derivative of the log. Both are evaluated with their expansions in
+    /// u = s/c when y is close to x, where the closed forms cancel out.
+    void logCoeffs(double s, double c, double& f, double& g)
+    {
+      if (c > 0 && s*s < 1e-3*c*c)
+      {
+        double u2 = s*s/(c*c);
+        f = (1 + u2*(-1./3 + u2*(1./5 + u2*(-1./7 + u2/9))))/c;
+        g = (-2./3 + u2*(4./5 + u2*(-6./7 + u2*8./9)))/(c*c*c);
+      }
+      else
+      {
+        double t = atan2(s, c);
+        f = t/s;
+        g = (c/(s*s + c*c) - f)/(s*s);
+      }
+    }
+  }
+
+  Sn::Sn(Index n)
+    : Manifold(n, n + 1, n + 1)
+  {
+    mnf_assert(n > 0 && "the dimension of a sphere must be positive");
+    name() = "S" + std::to_string(n);
+    setTypicalMagnitude(M_PI);
+  }
+
+  Sn::Sn(Index n, double magnitude)
+    : Manifold(n, n + 1, n + 1)
+  {
+    mnf_assert(n > 0 && "the dimension of a sphere must be positive");
+    name() = "S" + std::to_string(n);
+    setTypicalMagnitude(magnitude);
+  }
+
+  Sn::Sn(Index n, const ConstRefVec& magnitude)
+    : Manifold(n, n + 1, n + 1)
+  {
+    mnf_assert(n > 0 && "the dimension of a sphere must be positive");
+    mnf_assert(magnitude.size() == n + 1 && "magnitude on S^n must be of size n+1");
+    name() = "S" + std::to_string(n);
+    setTypicalMagnitude(magnitude);
+  }
+
+  bool Sn::isInM_(const ConstRefVec& val, const double& prec) const
+  {
+    return fabs(val.norm() - 1.0) < prec;
+  }
+
+  void Sn::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    out = in/in.norm();
+  }
+
+  size_t Sn::numberOfSubmanifolds() const
+  {
+    return 1;
+  }
+
+  bool Sn::isElementary() const
+  {
+    return true;
+  }
+
+  const Manifold& Sn::operator()(size_t i) const
+  {
+    mnf_assert(i < 1 && "invalid index");
+    return *this;
+  }
+
+  std::string Sn::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    std::string matPrefix = prefix + '[';
+    Eigen::IOFormat CleanFmt(prec, 0, ", ", "\n", matPrefix, "]");
+    std::stringstream ss;
+    ss << val.transpose().format(CleanFmt);
+    return ss.str();
+  }
+
+  void Sn::createRandomPoint_(RefVec out, double) const
+  {
+    out.setRandom();
+    out /= out.norm();
+  }
+
+  void Sn::retractCols(RefMat out, const ConstRefMat& x, const ConstRefMat& v)
+  {
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      double s = (x.col(j) + v.col(j)).norm();
+      out.col(j) = (x.col(j) + v.col(j))/s;
+    }
+  }
+
+  void Sn::logCols(RefMat out, const ConstRefMat& x, const ConstRefMat& y)
+  {
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      double c = x.col(j).dot(y.col(j));
+      double s = (y.col(j) - c*x.col(j)).norm();
+      double f, g;
+      logCoeffs(s, c, f, g);
+      out.col(j) = f*(y.col(j) - c*x.col(j));
+    }
+  }
+
+  void Sn::projCols(RefMat out, const ConstRefMat& in, const ConstRefMat& x)
+  {
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      double d = x.col(j).dot(in.col(j));
+      out.col(j) = in.col(j) - d*x.col(j);
+    }
+  }
+
+  void Sn::projRows(RefMat out, const ConstRefMat& in, const ConstRefVec& x)
+  {
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> a = ReusableTemporaryMap::threadBuffer().getMap(in.rows(), 1);
+    a.col(0).noalias() = in*x;
+    out = in;
+    out.noalias() -= a.col(0)*x.transpose();
+  }
+
+  void Sn::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    double s = (x + v).norm();
+    out = (x + v)/s;
+  }
+
+  void Sn::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    retractCols(out, x, v);
+  }
+
+  void Sn::retractRows(RefMat out, const ConstRefMat& x, const ConstRefMat& v)
+  {
+    //one plane per coordinate: the loops over the points of a chunk are
+    //vectorized
+    double s[batchChunk];
+    for (Index j0 = 0; j0 < x.rows(); j0 += batchChunk)
+    {
+      const Index m = std::min(batchChunk, x.rows() - j0);
+      std::fill(s, s + m, 0.);
+      for (Index i = 0; i < x.cols(); ++i)
+      {
+        for (Index j = 0; j < m; ++j)
+        {
+          const double a = x(j0 + j, i) + v(j0 + j, i);
+          s[j] += a*a;
+        }
+      }
+      for (Index j = 0; j < m; ++j)
+        s[j] = 1/sqrt(s[j]);
+      for (Index i = 0; i < x.cols(); ++i)
+      {
+        for (Index j = 0; j < m; ++j)
+          out(j0 + j, i) = s[j]*(x(j0 + j, i) + v(j0 + j, i));
+      }
+    }
+  }
+
+  void Sn::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    retractRows(out, x, v);
+  }
+
+  void Sn::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    logCols(out, x, y);
+  }
+
+  double Sn::distance(const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    double c = x.dot(y);
+    return atan2((y - c*x).norm(), c);
+  }
+
+  void Sn::projVec(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
+  {
+    out = in - (x.dot(in))*x;
+  }
+
+  void Sn::log0Cols(RefMat out, const ConstRefMat& x)
+  {
+    //Log_{e0}(x), the orthogonal part of x being its tail
+    Index n = x.rows() - 1;
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      double f, g;
+      logCoeffs(x.col(j).tail(n).norm(), x(0, j), f, g);
+      out.col(j).tail(n) = f*x.col(j).tail(n);
+      out(0, j) = 0;
+    }
+  }
+
+  void Sn::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    log0Cols(out, x);
+  }
+
+  void Sn::setZero_(RefVec out) const
+  {
+    out.setZero();
+    out[0] = 1;
+  }
+
+  Eigen::MatrixXd Sn::diffRetractation_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(-x*x.transpose());
+    J.diagonal().array() += 1;
+    return J;
+  }
+
+  void Sn::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    projRows(out, in, x);
+  }
+
+  void Sn::diffLog0(RefMat J, const ConstRefVec& x)
+  {
+    //Log_{e0}(x) = f(s, c) p, with c = x_0, p = (0, x_1, ..., x_n), s = |p|
+    //d/dx = f (I - e0 e0^T) + p (g p^T - e0^T/(s^2 + c^2))
+    Index n = x.size() - 1;
+    double c = x[0];
+    double s2 = x.tail(n).squaredNorm();
+    double f, g;
+    logCoeffs(sqrt(s2), c, f, g);
+    J.row(0).setZero();
+    J.bottomRightCorner(n, n).noalias() = g*x.tail(n)*x.tail(n).transpose();
+    J.bottomRightCorner(n, n).diagonal().array() += f;
+    J.col(0).tail(n) = -x.tail(n)/(s2 + c*c);
+  }
+
+  void Sn::applyDiffLog0(RefMat out, const ConstRefMat& in, const ConstRefVec& x)
+  {
+    Index n = x.size() - 1;
+    double c = x[0];
+    double s2 = x.tail(n).squaredNorm();
+    double f, g;
+    logCoeffs(sqrt(s2), c, f, g);
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> a = ReusableTemporaryMap::threadBuffer().getMap(in.rows(), 1);
+    a.col(0).noalias() = in.rightCols(n)*x.tail(n);
+    out.rightCols(n) = f*in.rightCols(n);
+    out.rightCols(n).noalias() += (g*a.col(0))*x.tail(n).transpose();
+    out.col(0) = -a.col(0)/(s2 + c*c);
+  }
+
+  Eigen::MatrixXd Sn::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(x.size(), x.size());
+    diffLog0(J, x);
+    return J;
+  }
+
+  void Sn::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    applyDiffLog0(out, in, x);
+  }
+
+  void Sn::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    //projection of the columns of in on the tangent space at x+v
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> a = ReusableTemporaryMap::threadBuffer().getMap(x.size() + in.cols(), 1);
+    a.col(0).head(x.size()) = (x + v)/(x + v).norm();
+    a.col(0).tail(in.cols()).noalias() = in.transpose()*a.col(0).head(x.size());
+    out = in;
+    out.noalias() -= a.col(0).head(x.size())*a.col(0).tail(in.cols()).transpose();
+  }
+
+  void Sn::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec&) const
+  {
+    projRows(out, in, x);
+  }
+
+  void Sn::tangentConstraint_(RefMat out, const ConstRefVec& x) const
+  {
+    out = x.transpose();
+  }
+
+  bool Sn::isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const
+  {
+    return fabs(x.dot(v)) < prec;
+  }
+
+  void Sn::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
+  {
+    projVec(out, in, x);
+  }
+
+  void Sn::limitMap_(RefVec out) const
+  {
+    out.setConstant(std::numeric_limits<double>::infinity());
+  }
+
+  void Sn::getTypicalMagnitude_(RefVec out) const
+  {
+    out = typicalMagnitude_;
+  }
+
+  void Sn::setTypicalMagnitude(double magnitude)
+  {
+    typicalMagnitude_.setConstant(tangentDim(), magnitude);
+  }
+
+  void Sn::setTypicalMagnitude(const ConstRefVec& out)
+  {
+    typicalMagnitude_ = out;
+  }
+
+  long Sn::getTypeId() const
+  {
+    long typeId = ::utils::hash::computeHash("Sn");
+    return typeId;
+  }
+}
@@ -0,0 +1,559 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <limits>
+#include <sstream>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include <manifolds/Stiefel.h>
+#include <manifolds/ReusableTemporaryMap.h>
+#include <manifolds/mnf_assert.h>
+
+namespace mnf
+{
+  namespace
+  {
+    typedef Eigen::Map<Eigen::MatrixXd> MatMap;
+    typedef Eigen::Map<const Eigen::MatrixXd> ConstMatMap;
+
+    /// \brief Cuts consecutive matrices out of a workspace
+    class Slicer
+    {
+    public:
+      explicit Slicer(double* data) : next_(data) {}
+
+      MatMap take(Index rows, Index cols)
+      {
+        MatMap m(next_, rows, cols);
+        next_ += rows*cols;
+        return m;
+      }
+
+    private:
+      double* next_;
+    };
+
+    /// \brief Replaces A by the Q factor of its thin QR decomposition, with a
+    /// positive diagonal for R. This is a modified Gram-Schmidt with one step of
+    /// reorthogonalization, done in place.
+    void orthonormalize(MatMap A)
+    {
+      for (Index k = 0; k < A.cols(); ++k)
+      {
+        for (int pass = 0; pass < 2; ++pass)
+        {
+          for (Index j = 0; j < k; ++j)
+            A.col(k) -= A.col(j).dot(A.col(k))*A.col(j);
+        }
+        double nk = A.col(k).norm();
+        mnf_assert(nk > 0 && "the matrix must have full column rank");
+        A.col(k) /= nk;
+      }
+    }
+
+    /// \brief Solves A X = B by Gaussian elimination with partial pivoting.
+    /// A is destroyed and B is replaced by X.
+    void solveInPlace(MatMap A, MatMap B)
+    {
+      const Index m = A.rows();
+      for (Index k = 0; k < m; ++k)
+      {
+        Index piv;
+        A.col(k).tail(m - k).cwiseAbs().maxCoeff(&piv);
+        piv += k;
+        if (piv != k)
+        {
+          A.row(k).swap(A.row(piv));
+          B.row(k).swap(B.row(piv));
+        }
+        mnf_assert(A(k, k) != 0 && "singular system");
+        for (Index i = k + 1; i < m; ++i)
+        {
+          double f = A(i, k)/A(k, k);
+          for (Index j = k + 1; j < m; ++j)
+            A(i, j) -= f*A(k, j);
+          for (Index j = 0; j < B.cols(); ++j)
+            B(i, j) -= f*B(k, j);
+        }
+      }
+      for (Index k = m - 1; k >= 0; --k)
+      {
+        for (Index j = 0; j < B.cols(); ++j)
+        {
+          double s = B(k, j);
+          for (Index i = k + 1; i < m; ++i)
+            s -= A(k, i)*B(i, j);
+          B(k, j) = s/A(k, k);
+        }
+      }
+    }
+
+    /// \brief Finds the upper triangular R such that \f$ MR + R^TM^T = B \f$,
+    /// for a symmetric B. Column j of R is given by a (j+1) x (j+1) system on
+    /// the leading principal submatrix of M. Uses 3p^2+p doubles of ws.
+    void solveTriangularSylvester(MatMap R, const ConstRefMat& M, const ConstRefMat& B, Slicer ws)
+    {
+      const Index p = M.rows();
+      MatMap S = ws.take(p, p);   //S = M R
+      MatMap sys = ws.take(p, p);
+      MatMap rhs = ws.take(p, 1);
+      R.setZero();
+      for (Index j = 0; j < p; ++j)
+      {
+        MatMap A(sys.data(), j + 1, j + 1);
+        MatMap b(rhs.data(), j + 1, 1);
+        A = M.topLeftCorner(j + 1, j + 1);
+        for (Index i = 0; i < j; ++i)
+          b(i, 0) = B(i, j) - S(j, i);
+        b(j, 0) = B(j, j)/2;
+        solveInPlace(A, b);
+        R.col(j).head(j + 1) = b;
+        S.col(j).noalias() = M.leftCols(j + 1)*b;
+      }
+    }
+
+    /// \brief Finds the symmetric L such that \f$ triu(M^T L) = triu(H)/2 \f$.
+    /// This is the adjoint of solveTriangularSylvester: for any symmetric B,
+    /// <L, B> = <H, R> where M R + R^T M^T = B. Column j of L is given by a
+    /// (j+1) x (j+1) system on the leading principal submatrix of M^T, from
+    /// the last column to the first. Uses p^2+p doubles of ws.
+    void solveAdjointTriangularSylvester(MatMap L, const ConstRefMat& M, const ConstRefMat& H, Slicer ws)
+    {
+      const Index p = M.rows();
+      MatMap sys = ws.take(p, p);
+      MatMap rhs = ws.take(p, 1);
+      for (Index j = p - 1; j >= 0; --j)
+      {
+        MatMap A(sys.data(), j + 1, j + 1);
+        MatMap b(rhs.data(), j + 1, 1);
+        A = M.topLeftCorner(j + 1, j + 1).transpose();
+        for (Index i = 0; i <= j; ++i)
+        {
+          b(i, 0) = H(i, j)/2;
+          for (Index c = j + 1; c < p; ++c)
+            b(i, 0) -= M(c, i)*L(c, j);
+        }
+        solveInPlace(A, b);
+        L.col(j).head(j + 1) = b;
+        L.row(j).head(j + 1) = b.transpose();
+      }
+    }
+
+    /// \brief V = Y R - X, the tangent vector at X such that qf(X+V) = Y.
+    /// Uses np+5p^2+p doubles of ws. V may alias X or Y.
+    void logQR(MatMap V, const ConstMatMap& X, const ConstMatMap& Y, Slicer ws)
+    {
+      const Index p = X.cols();
+      MatMap M = ws.take(p, p);
+      MatMap B = ws.take(p, p);
+      MatMap R = ws.take(p, p);
+      MatMap T = ws.take(X.rows(), p);
+      M.noalias() = X.transpose()*Y;
+      B.setIdentity();
+      B *= 2;
+      solveTriangularSylvester(R, M, B, ws);
+      T.noalias() = Y*R;
+      V = T - X;
+    }
+  }
+
+  Stiefel::Stiefel(Index n, Index p, Retractation retractation)
+    : Manifold(n*p - p*(p + 1)/2, n*p, n*p)
+    , n_(n)
+    , p_(p)
+    , retractationType_(retractation)
+    , workspaceSize_(3*n*p + 9*p*p + p)
+  {
+    mnf_assert(p > 0 && p <= n && "St(n, p) requires 1 <= p <= n");
+    name() = "St(" + std::to_string(n) + ", " + std::to_string(p) + ")";
+    setTypicalMagnitude(M_PI);
+    workspace();
+  }
+
+  Stiefel::Stiefel(Index n, Index p, double magnitude, Retractation retractation)
+    : Manifold(n*p - p*(p + 1)/2, n*p, n*p)
+    , n_(n)
+    , p_(p)
+    , retractationType_(retractation)
+    , workspaceSize_(3*n*p + 9*p*p + p)
+  {
+    mnf_assert(p > 0 && p <= n && "St(n, p) requires 1 <= p <= n");
+    name() = "St(" + std::to_string(n) + ", " + std::to_string(p) + ")";
+    setTypicalMagnitude(magnitude);
+    workspace();
+  }
+
+  Index Stiefel::ambientDim() const
+  {
+    return n_;
+  }
+
+  Index Stiefel::frameSize() const
+  {
+    return p_;
+  }
+
+  Stiefel::Retractation Stiefel::retractationType() const
+  {
+    return retractationType_;
+  }
+
+  Stiefel::MatMap Stiefel::mat(RefVec v) const
+  {
+    return MatMap(v.data(), n_, p_);
+  }
+
+  Stiefel::ConstMatMap Stiefel::mat(const ConstRefVec& v) const
+  {
+    return ConstMatMap(v.data(), n_, p_);
+  }
+
+  double* Stiefel::workspace(Index extra) const
+  {
+    return ReusableTemporaryMap::threadBuffer().getMap(workspaceSize_ + extra, 1).data();
+  }
+
+  void Stiefel::retract(MatMap out, const ConstMatMap& X, const ConstMatMap& V, double* ws) const
+  {
+    if (retractationType_ == QR)
+    {
+      out = X + V;
+      orthonormalize(out);
+      return;
+    }
+
+    //Cayley retractation with W = U Z^T, U = [P_X V, X] and Z = [X, -P_X V].
+    //By the Sherman-Morrison-Woodbury formula,
+    //R_X(V) = X + U (I - Z^T U/2)^{-1} Z^T X
+    const Index p = p_;
+    Slicer s(ws);
+    MatMap XtV = s.take(p, p);
+    MatMap PV = s.take(n_, p);
+    MatMap M = s.take(2*p, 2*p);
+    MatMap S = s.take(2*p, p);
+    MatMap Y = s.take(n_, p);
+    XtV.noalias() = X.transpose()*V;
+    PV = V;
+    PV.noalias() -= 0.5*X*XtV;
+    M.topLeftCorner(p, p).noalias() = -0.5*X.transpose()*PV;
+    M.topRightCorner(p, p).noalias() = -0.5*X.transpose()*X;
+    M.bottomLeftCorner(p, p).noalias() = 0.5*PV.transpose()*PV;
+    M.bottomRightCorner(p, p).noalias() = 0.5*PV.transpose()*X;
+    M.diagonal().array() += 1;
+    S.topRows(p).noalias() = X.transpose()*X;
+    S.bottomRows(p).noalias() = -PV.transpose()*X;
+    solveInPlace(M, S);
+    Y = X;
+    Y.noalias() += PV*S.topRows(p);
+    Y.noalias() += X*S.bottomRows(p);
+    out = Y;
+  }
+
+  bool Stiefel::isInM_(const ConstRefVec& val, const double& prec) const
+  {
+    ConstMatMap X = mat(val);
+    for (Index j = 0; j < p_; ++j)
+    {
+      for (Index i = 0; i <= j; ++i)
+      {
+        if (fabs(X.col(i).dot(X.col(j)) - (i == j ? 1 : 0)) >= prec)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void Stiefel::forceOnM_(RefVec out, const ConstRefVec& in) const
+  {
+    out = in;
+    orthonormalize(mat(out));
+  }
+
+  size_t Stiefel::numberOfSubmanifolds() const
+  {
+    return 1;
+  }
+
+  bool Stiefel::isElementary() const
+  {
+    return true;
+  }
+
+  const Manifold& Stiefel::operator()(size_t i) const
+  {
+    mnf_assert(i < 1 && "invalid index");
+    return *this;
+  }
+
+  std::string Stiefel::toString(const ConstRefVec& val, const std::string& prefix, int prec) const
+  {
+    std::string matPrefix = prefix + '[';
+    Eigen::IOFormat CleanFmt(prec, 0, ", ", "\n", matPrefix, "]");
+    std::stringstream ss;
+    ss << mat(val).format(CleanFmt);
+    return ss.str();
+  }
+
+  void Stiefel::createRandomPoint_(RefVec out, double) const
+  {
+    out.setRandom();
+    orthonormalize(mat(out));
+  }
+
+  void Stiefel::retractation_(RefVec out, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    retract(mat(out), mat(x), mat(v), workspace());
+  }
+
+  void Stiefel::batchRetractation_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    double* ws = workspace();
+    for (Index j = 0; j < x.cols(); ++j)
+    {
+      retract(MatMap(out.col(j).data(), n_, p_), ConstMatMap(x.col(j).data(), n_, p_),
+              ConstMatMap(v.col(j).data(), n_, p_), ws);
+    }
+  }
+
+  void Stiefel::batchRetractationSoA_(RefMat out, const ConstRefMat& x, const ConstRefMat& v) const
+  {
+    //each point is gathered from its row in the last 2np doubles of the workspace
+    const Index r = n_*p_;
+    double* ws = workspace(2*r);
+    MatMap X(ws + workspaceSize_, n_, p_);
+    MatMap V(ws + workspaceSize_ + r, n_, p_);
+    for (Index j = 0; j < x.rows(); ++j)
+    {
+      Eigen::Map<Eigen::RowVectorXd>(X.data(), r) = x.row(j);
+      Eigen::Map<Eigen::RowVectorXd>(V.data(), r) = v.row(j);
+      retract(X, ConstMatMap(X.data(), n_, p_), ConstMatMap(V.data(), n_, p_), ws);
+      out.row(j) = Eigen::Map<Eigen::RowVectorXd>(X.data(), r);
+    }
+  }
+
+  void Stiefel::pseudoLog_(RefVec out, const ConstRefVec& x, const ConstRefVec& y) const
+  {
+    logQR(mat(out), mat(x), mat(y), Slicer(workspace()));
+  }
+
+  void Stiefel::pseudoLog0_(RefVec out, const ConstRefVec& x) const
+  {
+    Slicer s(workspace());
+    MatMap E = s.take(n_, p_);
+    E.setIdentity();
+    logQR(mat(out), ConstMatMap(E.data(), n_, p_), mat(x), s);
+  }
+
+  void Stiefel::setZero_(RefVec out) const
+  {
+    mat(out).setIdentity();
+  }
+
+  Eigen::MatrixXd Stiefel::diffRetractation_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(Eigen::MatrixXd::Identity(n_*p_, n_*p_));
+    applyDiffRetractation_(J, J, x);
+    return J;
+  }
+
+  void Stiefel::applyDiffRetractation_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    //Each row g of in, seen as a n x p matrix G, is mapped to D^*(G) where D is
+    //the differential of the retractation at V=0. With A = X^T G:
+    // - QR: with B = X^T V, D(V) = V - XX^T V + X (tril(B, -1) - tril(B, -1)^T),
+    //   so that D^*(G) = G + X (tril(A - A^T, -1) - A)
+    // - Cayley: D(V) = V - XX^T V/2 - XV^T X/2, so that
+    //   D^*(G) = G - X (A + A^T)/2, which is the projection on TxM.
+    const Index r = n_*p_;
+    ConstMatMap X = mat(x);
+    Slicer s(workspace());
+    MatMap G = s.take(n_, p_);
+    MatMap A = s.take(p_, p_);
+    MatMap C = s.take(p_, p_);
+    for (Index k = 0; k < in.rows(); ++k)
+    {
+      Eigen::Map<Eigen::RowVectorXd>(G.data(), r) = in.row(k);
+      A.noalias() = X.transpose()*G;
+      for (Index j = 0; j < p_; ++j)
+      {
+        for (Index i = 0; i < p_; ++i)
+        {
+          if (retractationType_ == QR)
+            C(i, j) = (i > j ? A(i, j) - A(j, i) : 0) - A(i, j);
+          else
+            C(i, j) = -0.5*(A(i, j) + A(j, i));
+        }
+      }
+      G.noalias() += X*C;
+      out.row(k) = Eigen::Map<Eigen::RowVectorXd>(G.data(), r);
+    }
+  }
+
+  Eigen::MatrixXd Stiefel::diffPseudoLog0_(const ConstRefVec& x) const
+  {
+    Eigen::MatrixXd J(Eigen::MatrixXd::Identity(n_*p_, n_*p_));
+    applyDiffPseudoLog0_(J, J, x);
+    return J;
+  }
+
+  void Stiefel::applyDiffPseudoLog0_(RefMat out, const ConstRefMat& in, const ConstRefVec& x) const
+  {
+    //pseudoLog0(Y) = Y R - E where M R + R^T M^T = 2I with M = E^T Y.
+    //For dY = e_i e_k^T, the same equation gives M dR + dR^T M^T = Bd with
+    //Bd = -(dM R + R^T dM^T), and dV = dY R + Y dR, dM being zero for i >= p.
+    //For a row g of in, seen as a n x p matrix G, the coefficient (i, k) of
+    //g*J is thus (G R^T)_ik + <Y^T G, dR>. The second term is
+    //<Lambda, Bd> = -2 (Lambda R^T)_ik, where the symmetric Lambda is given by
+    //the adjoint equation triu(M^T Lambda) = triu(Y^T G)/2.
+    const Index r = n_*p_;
+    const Index p = p_;
+    ConstMatMap Y = mat(x);
+    Slicer s(workspace());
+    MatMap M = s.take(p, p);
+    MatMap B = s.take(p, p);
+    MatMap R = s.take(p, p);
+    MatMap H = s.take(p, p);
+    MatMap L = s.take(p, p);
+    MatMap G = s.take(n_, p);
+    MatMap O = s.take(n_, p);
+    M = Y.topRows(p);
+    B.setIdentity();
+    B *= 2;
+    solveTriangularSylvester(R, M, B, s);
+    for (Index k = 0; k < in.rows(); ++k)
+    {
+      Eigen::Map<Eigen::RowVectorXd>(G.data(), r) = in.row(k);
+      H.noalias() = Y.transpose()*G;
+      solveAdjointTriangularSylvester(L, M, H, s);
+      O.noalias() = G*R.transpose();
+      O.topRows(p).noalias() -= 2*L*R.transpose();
+      out.row(k) = Eigen::Map<Eigen::RowVectorXd>(O.data(), r);
+    }
+  }
+
+  void Stiefel::applyTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec& v) const
+  {
+    //projection of each column of in on the tangent space at y = x+v:
+    //U - Y (Y^T U + U^T Y)/2
+    Slicer s(workspace());
+    MatMap Y = s.take(n_, p_);
+    MatMap A = s.take(p_, p_);
+    MatMap C = s.take(p_, p_);
+    double* ws = s.take(2*n_*p_ + 7*p_*p_, 1).data();
+    retract(Y, mat(x), mat(v), ws);
+    for (Index k = 0; k < in.cols(); ++k)
+    {
+      ConstMatMap U(in.col(k).data(), n_, p_);
+      MatMap O(out.col(k).data(), n_, p_);
+      A.noalias() = Y.transpose()*U;
+      C = 0.5*(A + A.transpose());
+      O = U;
+      O.noalias() -= Y*C;
+    }
+  }
+
+  void Stiefel::applyInvTransport_(RefMat out, const ConstRefMat& in, const ConstRefVec& x, const ConstRefVec&) const
+  {
+    //the projection on TxM is self-adjoint
+    const Index r = n_*p_;
+    ConstMatMap X = mat(x);
+    Slicer s(workspace());
+    MatMap G = s.take(n_, p_);
+    MatMap A = s.take(p_, p_);
+    MatMap C = s.take(p_, p_);
+    for (Index k = 0; k < in.rows(); ++k)
+    {
+      Eigen::Map<Eigen::RowVectorXd>(G.data(), r) = in.row(k);
+      A.noalias() = X.transpose()*G;
+      C = 0.5*(A + A.transpose());
+      G.noalias() -= X*C;
+      out.row(k) = Eigen::Map<Eigen::RowVectorXd>(G.data(), r);
+    }
+  }
+
+  void Stiefel::tangentConstraint_(RefMat out, const ConstRefVec& x) const
+  {
+    //one row per entry (i, j), i <= j, of X^T V + V^T X
+    ConstMatMap X = mat(x);
+    out.setZero();
+    Index row = 0;
+    for (Index j = 0; j < p_; ++j)
+    {
+      for (Index i = 0; i <= j; ++i, ++row)
+      {
+        out.block(row, j*n_, 1, n_) = X.col(i).transpose();
+        if (i != j)
+          out.block(row, i*n_, 1, n_) = X.col(j).transpose();
+      }
+    }
+  }
+
+  bool Stiefel::isInTxM_(const ConstRefVec& x, const ConstRefVec& v, const double& prec) const
+  {
+    ConstMatMap X = mat(x);
+    ConstMatMap V = mat(v);
+    for (Index j = 0; j < p_; ++j)
+    {
+      for (Index i = 0; i <= j; ++i)
+      {
+        if (fabs(X.col(i).dot(V.col(j)) + X.col(j).dot(V.col(i))) >= prec)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  void Stiefel::forceOnTxM_(RefVec out, const ConstRefVec& in, const ConstRefVec& x) const
+  {
+    ConstMatMap X = mat(x);
+    Slicer s(workspace());
+    MatMap A = s.take(p_, p_);
+    MatMap C = s.take(p_, p_);
+    A.noalias() = X.transpose()*mat(in);
+    C = 0.5*(A + A.transpose());
+    out = in;
+    mat(out).noalias() -= X*C;
+  }
+
+  void Stiefel::limitMap_(RefVec out) const
+  {
+    out.setConstant(std::numeric_limits<double>::infinity());
+  }
+
+  void Stiefel::getTypicalMagnitude_(RefVec out) const
+  {
+    out = typicalMagnitude_;
+  }
+
+  void Stiefel::setTypicalMagnitude(double magnitude)
+  {
+    typicalMagnitude_.setConstant(tangentDim(), magnitude);
+  }
+
+  void Stiefel::setTypicalMagnitude(const ConstRefVec& out)
+  {
+    mnf_assert(out.size() == tangentDim());
+    typicalMagnitude_ = out;
+  }
+
+  long Stiefel::getTypeId() const
+  {
+    long typeId = ::utils::hash::computeHash("Stiefel");
+    return typeId;
+  }
+}
@@ -0,0 +1,236 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <manifolds/ThreadPool.h>
+#include <manifolds/mnf_assert.h>
+
+#ifdef __linux__
+# include <pthread.h>
+# include <sched.h>
+#endif
+
+namespace mnf
+{
+  namespace
+  {
+    /// True in the worker threads, and in a thread running a parallel loop
+    thread_local bool inParallelRegion = false;
+
+    const std::uint64_t lowMask = 0xffffffffu;
+
+    std::uint64_t pack(std::uint64_t b, std::uint64_t e)
+    {
+      return (b << 32) | e;
+    }
+
+    void unpack(std::uint64_t r, Index& b, Index& e)
+    {
+      b = static_cast<Index>(r >> 32);
+      e = static_cast<Index>(r & lowMask);
+    }
+
+    void pinToCore(std::thread& t, size_t core)
+    {
+#ifdef __linux__
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(static_cast<int>(core), &set);
+      pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &set);
+#else
+      (void)t;
+      (void)core;
+#endif
+    }
+  }
+
+  ThreadPool::ThreadPool(size_t nThreads, Affinity affinity)
+    : affinity_(affinity)
+    , job_(0x0)
+    , begin_(0)
+    , grain_(1)
+    , active_(0)
+    , generation_(0)
+    , stop_(false)
+  {
+    size_t hw = std::thread::hardware_concurrency();
+    if (nThreads == static_cast<size_t>(-1))
+      nThreads = hw > 1 ? hw - 1 : 0;
+    slots_.reset(new Slot[nThreads + 1]);
+    for (size_t i = 0; i <= nThreads; ++i)
+      slots_[i].range.store(0, std::memory_order_relaxed);
+    workers_.reserve(nThreads);
+    for (size_t i = 0; i < nThreads; ++i)
+    {
+      workers_.push_back(std::thread(&ThreadPool::workerLoop, this, i + 1));
+      if (affinity_ == PinToCores && hw > 0)
+        pinToCore(workers_.back(), (i + 1) % hw);
+    }
+  }
+
+  ThreadPool::~ThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& w : workers_)
+      w.join();
+  }
+
+  void ThreadPool::parallelFor(Index begin, Index end, Index grain, const std::function<void(Index, Index)>& f)
+  {
+    mnf_assert(grain > 0);
+    if (end <= begin)
+      return;
+    std::unique_lock<std::mutex> busy(busy_, std::try_to_lock);
+    if (workers_.empty() || inParallelRegion || !busy.owns_lock() || end - begin <= grain)
+    {
+      f(begin, end);
+      return;
+    }
+    mnf_assert(static_cast<std::uint64_t>(end - begin) <= lowMask && "Range too large for a parallel loop");
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::uint64_t n = static_cast<std::uint64_t>(end - begin);
+      std::uint64_t p = size();
+      for (std::uint64_t i = 0; i < p; ++i)
+        slots_[i].range.store(pack(n * i / p, n * (i + 1) / p), std::memory_order_relaxed);
+      job_ = &f;
+      begin_ = begin;
+      grain_ = grain;
+      active_ = workers_.size();
+      error_ = std::exception_ptr();
+      ++generation_;
+    }
+    wake_.notify_all();
+
+    inParallelRegion = true;
+    runChunks(0);
+    inParallelRegion = false;
+
+    std::exception_ptr error;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      done_.wait(lock, [this] { return active_ == 0; });
+      job_ = 0x0;
+      error = error_;
+    }
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  ThreadPool& ThreadPool::global()
+  {
+    static ThreadPool pool;
+    return pool;
+  }
+
+  void ThreadPool::workerLoop(size_t id)
+  {
+    inParallelRegion = true;
+    unsigned long seen = 0;
+    for (;;)
+    {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this, seen] { return stop_ || generation_ != seen; });
+        if (stop_)
+          return;
+        seen = generation_;
+      }
+      runChunks(id);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--active_ == 0)
+          done_.notify_one();
+      }
+    }
+  }
+
+  void ThreadPool::runChunks(size_t id)
+  {
+    Index b, e;
+    do
+    {
+      while (takeChunk(id, b, e))
+      {
+        try
+        {
+          (*job_)(begin_ + b, begin_ + e);
+        }
+        catch (...)
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (!error_)
+            error_ = std::current_exception();
+        }
+      }
+    } while (steal(id));
+  }
+
+  bool ThreadPool::takeChunk(size_t id, Index& b, Index& e)
+  {
+    std::atomic<std::uint64_t>& range = slots_[id].range;
+    std::uint64_t r = range.load(std::memory_order_acquire);
+    for (;;)
+    {
+      Index rb, re;
+      unpack(r, rb, re);
+      if (rb >= re)
+        return false;
+      Index next = std::min(rb + grain_, re);
+      if (range.compare_exchange_weak(r, pack(static_cast<std::uint64_t>(next), static_cast<std::uint64_t>(re)),
+                                      std::memory_order_acq_rel, std::memory_order_acquire))
+      {
+        b = rb;
+        e = next;
+        return true;
+      }
+    }
+  }
+
+  bool ThreadPool::steal(size_t id)
+  {
+    // The slot of the thief is empty, hence no other thread modifies it and
+    // the stolen range can be stored in it directly.
+    size_t p = size();
+    for (size_t k = 1; k < p; ++k)
+    {
+      std::atomic<std::uint64_t>& victim = slots_[(id + k) % p].range;
+      std::uint64_t r = victim.load(std::memory_order_acquire);
+      for (;;)
+      {
+        Index b, e;
+        unpack(r, b, e);
+        if (b >= e)
+          break;
+        Index mid = e - b <= grain_ ? b : b + (e - b) / 2;
+        if (victim.compare_exchange_weak(r, pack(static_cast<std::uint64_t>(b), static_cast<std::uint64_t>(mid)),
+                                         std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+          slots_[id].range.store(pack(static_cast<std::uint64_t>(mid), static_cast<std::uint64_t>(e)),
+                                 std::memory_order_release);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+}
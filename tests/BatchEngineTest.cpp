@@ -0,0 +1,162 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifold 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+#include <manifolds/defs.h>
+#include <manifolds/BatchEngine.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/RealSpace.h>
+#include <manifolds/SO3.h>
+#include <manifolds/ExpMapMatrix.h>
+#include <manifolds/ExpMapQuaternion.h>
+#include <manifolds/CartesianProduct.h>
+#include <manifolds/ThreadPool.h>
+
+using namespace mnf;
+
+BOOST_AUTO_TEST_CASE(ThreadPoolWorkStealing)
+{
+  ThreadPool pool(3, ThreadPool::PinToCores);
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+  BOOST_CHECK_EQUAL(pool.affinity(), ThreadPool::PinToCores);
+
+  //the first quarter of the range, given to the calling thread, is much
+  //slower than the rest: the other threads have to steal from it.
+  std::vector<int> count(2000, 0);
+  std::atomic<int> tooLarge(0);
+  pool.parallelFor(100, 2100, 5, [&](Index b, Index e)
+  {
+    if (e - b > 5)
+      ++tooLarge;
+    for (Index i = b; i < e; ++i)
+    {
+      if (i < 600)
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+      ++count[static_cast<size_t>(i - 100)];
+    }
+  });
+  BOOST_CHECK_EQUAL(tooLarge.load(), 0);
+  BOOST_CHECK(std::count(count.begin(), count.end(), 1) == 2000);
+
+  //exceptions are forwarded to the caller, and the pool can be used again
+  BOOST_CHECK_THROW(pool.parallelFor(0, 100, 1, [](Index b, Index) { if (b == 42) throw std::runtime_error("42"); }),
+                    std::runtime_error);
+  std::atomic<Index> sum(0);
+  pool.parallelFor(0, 100, 3, [&sum](Index b, Index e) { for (Index i = b; i < e; ++i) sum += i; });
+  BOOST_CHECK_EQUAL(sum.load(), 4950);
+}
+
+namespace
+{
+  PointSet randomSet(const Manifold& M, Index n, PointSet::Layout layout)
+  {
+    PointSet S(M);
+    S.reserve(n);
+    for (Index j = 0; j < n; ++j)
+      S.push_back(M.createRandomPoint().value());
+    S.setLayout(layout);
+    return S;
+  }
+
+  //Compares the results of the engine with the ones of the PointSet methods
+  void checkEngine(const BatchEngine& engine, const Manifold& M, Index n, PointSet::Layout layout)
+  {
+    bool aos = layout == PointSet::ArrayOfStructures;
+    Index t = M.tangentDim();
+    PointSet X = randomSet(M, n, layout);
+    Eigen::MatrixXd v = 0.5*Eigen::MatrixXd::Random(aos ? t : n, aos ? n : t);
+
+    PointSet Y(M, 0, layout), Yref(M, 0, layout);
+    engine.retractation(Y, X, v);
+    X.retractation(Yref, v);
+    BOOST_CHECK_EQUAL(Y.size(), n);
+    BOOST_CHECK_EQUAL(Y.values(), Yref.values());
+    BOOST_CHECK(engine.isInM(Y));
+
+    Eigen::MatrixXd l(v.rows(), v.cols()), lref(v.rows(), v.cols());
+    engine.pseudoLog(l, X, Y);
+    X.pseudoLog(lref, Y);
+    BOOST_CHECK_EQUAL(l, lref);
+
+    engine.pseudoLog0(l, Y);
+    Y.pseudoLog0(lref);
+    BOOST_CHECK_EQUAL(l, lref);
+
+    engine.increment(X, v);
+    BOOST_CHECK_EQUAL(X.values(), Y.values());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(BatchEngineMatchesPointSet)
+{
+  ThreadPool pool(3);
+  BatchEngine engine(pool);
+  BOOST_CHECK_EQUAL(engine.threadCount(), 4);
+
+  RealSpace R3(3);
+  SO3<ExpMapMatrix> RotMat;
+  SO3<ExpMapQuaternion> RotQuat;
+  CartesianProduct P(R3, RotMat);
+  BOOST_CHECK_EQUAL(BatchEngine::chunkSize(RotQuat), BatchEngine::ChunkDoubles/4);
+  BOOST_CHECK_EQUAL(BatchEngine::chunkSize(P), BatchEngine::ChunkDoubles/12);
+
+  checkEngine(engine, RotQuat, 2000, PointSet::ArrayOfStructures);
+  checkEngine(engine, RotQuat, 2000, PointSet::StructureOfArrays);
+  checkEngine(engine, P, 1000, PointSet::ArrayOfStructures);
+  checkEngine(engine, P, 1000, PointSet::StructureOfArrays);
+  checkEngine(engine, R3, 3, PointSet::ArrayOfStructures);
+
+  PointSet X = randomSet(RotQuat, 1000, PointSet::StructureOfArrays);
+  X.values()(777, 2) += 0.1;
+  BOOST_CHECK(!engine.isInM(X));
+}
+
+BOOST_AUTO_TEST_CASE(BatchEngineCustomJob)
+{
+  ThreadPool pool(3);
+  BatchEngine engine(pool);
+  std::vector<int> count(500, 0);
+  std::atomic<int> sharedScratch(0);
+  engine.run(500, 16, [&](Index b, Index e, ReusableTemporaryMap& scratch)
+  {
+    //each worker has its own scratch, so no other chunk can overwrite it
+    Eigen::Map<Eigen::MatrixXd, Eigen::Aligned> m = scratch.getMap(e - b, 1);
+    for (Index i = b; i < e; ++i)
+      m(i - b, 0) = static_cast<double>(i);
+    std::this_thread::yield();
+    for (Index i = b; i < e; ++i)
+    {
+      if (m(i - b, 0) != static_cast<double>(i))
+        ++sharedScratch;
+      ++count[static_cast<size_t>(i)];
+    }
+  });
+  BOOST_CHECK_EQUAL(sharedScratch.load(), 0);
+  BOOST_CHECK(std::count(count.begin(), count.end(), 1) == 500);
+}
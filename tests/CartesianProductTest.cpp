@@ -15,6 +15,7 @@
 // manifolds. If not, see
 // <http://www.gnu.org/licenses/>.
 
+#include <algorithm>
 #include <iostream>
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -26,6 +27,7 @@
 #include <manifolds/RealSpace.h>
 #include <manifolds/CartesianProduct.h>
 #include <manifolds/CartesianPower.h>
+#include <manifolds/ThreadPool.h>
 #include <manifolds/Point.h>
 #include <manifolds/ExpMapMatrix.h>
 #include <manifolds/ExpMapQuaternion.h>
@@ -55,7 +57,7 @@ BOOST_AUTO_TEST_CASE(CartProdConstructor)
   BOOST_CHECK_EQUAL(PowS.dim(), 30);
   BOOST_CHECK_EQUAL(PowS.representationDim(), 48);
   BOOST_CHECK_EQUAL(PowS.numberOfSubmanifolds(), 3);
-  std::string solName("R2xR3xR2xSO3xR2xR3xR2xSO3xR2xR3xR2xSO3");
+  std::string solName("(R2xR3xR2xSO3)^3");
   BOOST_CHECK(PowS.name().compare(solName) == 0);
   Eigen::VectorXd expectedTypicalMag(30);
   expectedTypicalMag << 1, 1,
@@ -544,6 +546,258 @@ BOOST_AUTO_TEST_CASE(CartProdLimitMap)
   BOOST_CHECK_EQUAL(expectedRes, res);
 }
 
+BOOST_AUTO_TEST_CASE(CartProdDiffBlocks)
+{
+  RealSpace R3(3);
+  SO3<ExpMapQuaternion> RotSpace;
+  CartesianPower Rots(RotSpace, 4);
+  CartesianProduct P(R3, Rots);
+  CartesianProduct S(P, RotSpace);
+  Eigen::VectorXd x = S.createRandomPoint().value();
+
+  BlockDiagonalMatrix J = S.diffRetractationBlocks(x);
+  BOOST_CHECK_EQUAL(J.numberOfBlocks(), 6);
+  BOOST_CHECK_EQUAL(J.rows(), S.representationDim());
+  BOOST_CHECK_EQUAL(J.cols(), S.tangentDim());
+  Eigen::MatrixXd Jd = S.diffRetractation(x);
+  BOOST_CHECK(J.toDense().isApprox(Jd));
+  BOOST_CHECK(Eigen::MatrixXd(J.toSparse()).isApprox(Jd));
+
+  BlockDiagonalMatrix K = S.diffPseudoLog0Blocks(x);
+  BOOST_CHECK_EQUAL(K.numberOfBlocks(), 6);
+  BOOST_CHECK(K.toDense().isApprox(S.diffPseudoLog0(x)));
+
+  Eigen::MatrixXd A = Eigen::MatrixXd::Random(4, S.representationDim());
+  Eigen::MatrixXd B = Eigen::MatrixXd::Random(S.tangentDim(), 2);
+  BOOST_CHECK((A*J).isApprox(A*Jd));
+  BOOST_CHECK((J*B).isApprox(Jd*B));
+  Eigen::SparseMatrix<double> As = A.sparseView();
+  Eigen::SparseMatrix<double> Bs = B.sparseView();
+  BOOST_CHECK(Eigen::MatrixXd(As*J).isApprox(A*Jd));
+  BOOST_CHECK(Eigen::MatrixXd(J*Bs).isApprox(Jd*B));
+}
+
+BOOST_AUTO_TEST_CASE(CartProdNestedTangentConstraint)
+{
+  RealSpace R2(2);
+  RealSpace R3(3);
+  S2 Sphere;
+  CartesianProduct A(R2, Sphere);
+  CartesianProduct B(Sphere, R3);
+  CartesianProduct C(A, B);
+  C.multiply(Sphere);
+  Eigen::VectorXd x = C.createRandomPoint().value();
+  Eigen::MatrixXd M(3, C.tangentDim());
+  C.tangentConstraint(M, x);
+  Eigen::MatrixXd expected = Eigen::MatrixXd::Zero(3, 14);
+  expected.block<1, 3>(0, 2) = x.segment<3>(2).transpose();
+  expected.block<1, 3>(1, 5) = x.segment<3>(5).transpose();
+  expected.block<1, 3>(2, 11) = x.segment<3>(11).transpose();
+  BOOST_CHECK_EQUAL(M, expected);
+}
+
+BOOST_AUTO_TEST_CASE(CartPowerMatchesProduct)
+{
+  SO3<ExpMapQuaternion> RotSpace;
+  RealSpace R2(2);
+  CartesianProduct S(RotSpace, R2);
+  const int n = 50;
+  CartesianPower Pow(S, n);
+  CartesianProduct Prod;
+  for (int i = 0; i < n; ++i)
+    Prod.multiply(S);
+
+  BOOST_CHECK_EQUAL(Pow.dim(), Prod.dim());
+  BOOST_CHECK_EQUAL(Pow.tangentDim(), Prod.tangentDim());
+  BOOST_CHECK_EQUAL(Pow.representationDim(), Prod.representationDim());
+  BOOST_CHECK_EQUAL(Pow.numberOfSubmanifolds(), n);
+  BOOST_CHECK_EQUAL(Pow(n-1).name(), S.name());
+  //a power has its own type, distinct from the equivalent product
+  BOOST_CHECK(!Pow.isSameType(Prod));
+  BOOST_CHECK(Pow.isSameType(CartesianPower(S, 2)));
+
+  Eigen::VectorXd x = Prod.createRandomPoint().value();
+  Eigen::VectorXd y = Prod.createRandomPoint().value();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(Prod.tangentDim());
+  BOOST_CHECK(Pow.isInM(x));
+
+  Eigen::VectorXd rPow(Pow.representationDim()), rProd(Prod.representationDim());
+  Pow.retractation(rPow, x, v);
+  Prod.retractation(rProd, x, v);
+  BOOST_CHECK(rPow.isApprox(rProd, 1e-12));
+  Pow.retractation(x, x, v);
+  BOOST_CHECK(x.isApprox(rProd, 1e-12));
+
+  Eigen::VectorXd lPow(Pow.tangentDim()), lProd(Prod.tangentDim());
+  Pow.pseudoLog(lPow, x, y);
+  Prod.pseudoLog(lProd, x, y);
+  BOOST_CHECK(lPow.isApprox(lProd, 1e-12));
+
+  BOOST_CHECK(Pow.diffRetractation(x).isApprox(Prod.diffRetractation(x), 1e-12));
+  Eigen::MatrixXd in = Eigen::MatrixXd::Random(3, Pow.representationDim());
+  Eigen::MatrixXd outPow(3, Pow.tangentDim()), outProd(3, Prod.tangentDim());
+  Pow.applyDiffRetractation(outPow, in, x);
+  Prod.applyDiffRetractation(outProd, in, x);
+  BOOST_CHECK(outPow.isApprox(outProd, 1e-12));
+
+  Eigen::MatrixXd X(Pow.representationDim(), 3), V(Pow.tangentDim(), 3);
+  for (Index j = 0; j < 3; ++j)
+  {
+    X.col(j) = Prod.createRandomPoint().value();
+    V.col(j) = Eigen::VectorXd::Random(Pow.tangentDim());
+  }
+  Eigen::MatrixXd OPow(Pow.representationDim(), 3), OProd(Prod.representationDim(), 3);
+  Pow.batchRetractation(OPow, X, V);
+  Prod.batchRetractation(OProd, X, V);
+  BOOST_CHECK(OPow.isApprox(OProd, 1e-12));
+  Eigen::MatrixXd Xbig(Pow.representationDim() + 1, 3);
+  Xbig.topRows(Pow.representationDim()) = X;
+  Pow.batchRetractation(OPow, Xbig.topRows(Pow.representationDim()), V);
+  BOOST_CHECK(OPow.isApprox(OProd, 1e-12));
+
+  S2 Sphere;
+  CartesianPower PowS2(Sphere, n);
+  BOOST_CHECK_EQUAL(PowS2.name(), "S2^50");
+  Eigen::VectorXd z = PowS2.createRandomPoint().value();
+  Eigen::MatrixXd C(n, 3*n);
+  PowS2.tangentConstraint(C, z);
+  for (Index i = 0; i < n; ++i)
+    BOOST_CHECK(C.block(i, 3*i, 1, 3).transpose().isApprox(z.segment<3>(3*i)));
+}
+
+BOOST_AUTO_TEST_CASE(CartProdParallel)
+{
+  RealSpace R3(3);
+  SO3<ExpMapMatrix> RotSpace;
+  S2 Sphere;
+  CartesianProduct Serial, Parallel;
+  for (int i = 0; i < 100; ++i)
+  {
+    Serial.multiply(R3).multiply(RotSpace).multiply(Sphere);
+    Parallel.multiply(R3).multiply(RotSpace).multiply(Sphere);
+  }
+  ThreadPool pool(3);
+  Parallel.setParallelThreshold(1, &pool);
+  BOOST_CHECK_EQUAL(Parallel.parallelThreshold(), 1);
+
+  Index r = Serial.representationDim();
+  Index t = Serial.tangentDim();
+  Eigen::VectorXd x = Serial.createRandomPoint().value();
+  Eigen::VectorXd y = Serial.createRandomPoint().value();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(t);
+  Serial.forceOnTxM(v, v, x);
+  Eigen::MatrixXd in = Eigen::MatrixXd::Random(5, r);
+  Eigen::MatrixXd inT = Eigen::MatrixXd::Random(t, 5);
+
+  Eigen::VectorXd zs(r), zp(r), ls(t), lp(t);
+  Serial.retractation(zs, x, v);
+  Parallel.retractation(zp, x, v);
+  BOOST_CHECK(zs == zp);
+  Serial.pseudoLog(ls, x, y);
+  Parallel.pseudoLog(lp, x, y);
+  BOOST_CHECK(ls == lp);
+  BOOST_CHECK(Parallel.isInM(x));
+  BOOST_CHECK(!Parallel.isInM(Eigen::VectorXd::Constant(r, 2)));
+  BOOST_CHECK(Parallel.isInTxM(x, v));
+
+  Eigen::MatrixXd Js(5, t), Jp(5, t);
+  Serial.applyDiffRetractation(Js, in, x);
+  Parallel.applyDiffRetractation(Jp, in, x);
+  BOOST_CHECK(Js == Jp);
+  Eigen::MatrixXd Ts(t, 5), Tp(t, 5);
+  Serial.applyTransport(Ts, inT, x, v);
+  Parallel.applyTransport(Tp, inT, x, v);
+  BOOST_CHECK(Ts == Tp);
+  Eigen::MatrixXd Cs(t - Serial.dim(), t), Cp(t - Serial.dim(), t);
+  Serial.tangentConstraint(Cs, x);
+  Parallel.tangentConstraint(Cp, x);
+  BOOST_CHECK(Cs == Cp);
+
+#ifndef NDEBUG
+  //exceptions thrown in the threads are forwarded to the caller
+  Eigen::VectorXd bad = 100*v;
+  BOOST_CHECK_THROW(Parallel.retractation(zp, x, bad), mnf::mnf_exception);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(CartProdRowParallel)
+{
+  RealSpace R3(3);
+  SO3<ExpMapMatrix> RotSpace;
+  SO3<ExpMapQuaternion> RotQuat;
+  CartesianProduct P;
+  for (int i = 0; i < 5; ++i)
+    P.multiply(R3).multiply(RotSpace).multiply(RotQuat);
+  Index r = P.representationDim();
+  Index t = P.tangentDim();
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  Eigen::MatrixXd in = Eigen::MatrixXd::Random(3001, r);
+  Eigen::MatrixXd inT = Eigen::MatrixXd::Random(3001, t);
+  Eigen::MatrixXd Js(3001, t), Jp(3001, t), Ks(3001, r), Kp(3001, r);
+  P.applyDiffRetractation(Js, in, x);
+  P.applyDiffPseudoLog0(Ks, inT, x);
+
+  ThreadPool pool(3);
+  P.setRowParallelThreshold(1000, &pool);
+  BOOST_CHECK_EQUAL(P.rowParallelThreshold(), 1000);
+  P.applyDiffRetractation(Jp, in, x);
+  P.applyDiffPseudoLog0(Kp, inT, x);
+  BOOST_CHECK(Jp.isApprox(Js));
+  BOOST_CHECK(Kp.isApprox(Ks));
+
+  //both parallel modes can be combined
+  P.setParallelThreshold(2, &pool);
+  Jp.setZero();
+  P.applyDiffRetractation(Jp, in, x);
+  BOOST_CHECK(Jp.isApprox(Js));
+}
+
+BOOST_AUTO_TEST_CASE(CartProdRowTiles)
+{
+  RealSpace R3(3);
+  SO3<ExpMapMatrix> RotSpace;
+  S2 Sphere;
+  CartesianProduct P;
+  for (int i = 0; i < 4; ++i)
+    P.multiply(R3).multiply(RotSpace).multiply(Sphere);
+  BOOST_CHECK_EQUAL(P.rowTileSize(), 0);
+  Index r = P.representationDim();
+  Index t = P.tangentDim();
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(t);
+  P.forceOnTxM(v, v, x);
+  Eigen::MatrixXd in = Eigen::MatrixXd::Random(5000, r);
+  Eigen::MatrixXd inT = Eigen::MatrixXd::Random(5000, t);
+
+  Eigen::MatrixXd J(5000, t), H(5000, t);
+  P.applyDiffRetractation(J, in, x);
+  P.applyInvTransport(H, inT, x, v);
+
+  Index sizes[] = {1, 64, 777};
+  for (Index s : sizes)
+  {
+    P.setRowTileSize(s);
+    Eigen::MatrixXd Jt(5000, t), Ht(5000, t);
+    P.applyDiffRetractation(Jt, in, x);
+    P.applyInvTransport(Ht, inT, x, v);
+    BOOST_CHECK(Jt.isApprox(J));
+    BOOST_CHECK(Ht.isApprox(H));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ThreadPoolParallelFor)
+{
+  ThreadPool pool(3);
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+  std::vector<int> count(1000, 0);
+  pool.parallelFor(0, 1000, 7, [&count](Index b, Index e)
+  {
+    for (Index i = b; i < e; ++i)
+      ++count[static_cast<size_t>(i)];
+  });
+  BOOST_CHECK(std::count(count.begin(), count.end(), 1) == 1000);
+}
+
 BOOST_AUTO_TEST_CASE(CardProdGetView)
 {
   RealSpace R2(2);
@@ -576,6 +830,39 @@ BOOST_AUTO_TEST_CASE(CardProdGetView)
   BOOST_CHECK(xR2.isApprox(S.getView<T>(xT,2)));
 }
 
+BOOST_AUTO_TEST_CASE(CardProdBatchRetractation)
+{
+  const Index N = 20;
+  RealSpace R3(3);
+  S2 S;
+  SO3<ExpMapMatrix> RotSpaceM;
+  SO3<ExpMapQuaternion> RotSpaceQ;
+  CartesianProduct R3S2(R3, S);
+  CartesianProduct SO3SO3(RotSpaceM, RotSpaceQ);
+  CartesianProduct P(R3S2, SO3SO3);
+  Eigen::MatrixXd X(P.representationDim(), N);
+  Eigen::MatrixXd V(P.tangentDim(), N);
+  for (Index j = 0; j < N; ++j)
+  {
+    P.createRandomPoint(X.col(j));
+    Eigen::VectorXd v = 0.5*Eigen::VectorXd::Random(P.tangentDim());
+    P.forceOnTxM(V.col(j), v, X.col(j));
+  }
+
+  Eigen::MatrixXd Z(P.representationDim(), N);
+  P.batchRetractation(Z, X, V);
+  Eigen::VectorXd z(P.representationDim());
+  for (Index j = 0; j < N; ++j)
+  {
+    P.retractation(z, X.col(j), V.col(j));
+    BOOST_CHECK(z.isApprox(Z.col(j)));
+  }
+
+  //in place
+  P.batchRetractation(X, X, V);
+  BOOST_CHECK(X.isApprox(Z));
+}
+
 #if   EIGEN_WORLD_VERSION > 3 \
   || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
   || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
@@ -595,6 +882,7 @@ BOOST_AUTO_TEST_CASE(CardProdNoAllocation)
   Index dim = S.dim();
   Index repDim = S.representationDim();
   Eigen::VectorXd x = Eigen::VectorXd::Random(repDim);
+  Eigen::VectorXd x0 = S.getZero().value();
   Eigen::VectorXd p = Eigen::VectorXd::Random(dim);
   Eigen::VectorXd y = Eigen::VectorXd::Random(repDim);
   Eigen::VectorXd z(repDim);
@@ -616,6 +904,7 @@ BOOST_AUTO_TEST_CASE(CardProdNoAllocation)
   Eigen::internal::set_is_malloc_allowed(false);
   utils::set_is_malloc_allowed(false);
   {
+    BOOST_CHECK(S.isInM(x0));
     S.retractation(z, x, p);
     S.pseudoLog(d, y, x);
     S.pseudoLog0(d, x);
@@ -21,6 +21,10 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include <manifolds/defs.h>
 #include <manifolds/utils.h>
 #include <manifolds/Point.h>
@@ -61,3 +65,36 @@ BOOST_AUTO_TEST_CASE(ManifoldRefCounter)
 {
   CHECK_THROW_IN_DEBUG(createR3Point(), mnf::mnf_exception);
 }
+
+BOOST_AUTO_TEST_CASE(ManifoldConcurrentCreation)
+{
+  const size_t nThreads = 4;
+  const size_t n = 500;
+  RealSpace R3(3);
+  std::vector<std::vector<long> > ids(nThreads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < nThreads; ++i)
+  {
+    threads.push_back(std::thread([&R3, &ids, i, n]()
+    {
+      for (size_t j = 0; j < n; ++j)
+      {
+        RealSpace R(2);
+        Point x = R.createPoint();
+        Point y = R3.getZero();
+        ids[i].push_back(R.getInstanceId());
+      }
+    }));
+  }
+  for (auto& t : threads)
+    t.join();
+
+  //all the ids are different
+  std::vector<long> all;
+  for (const auto& v : ids)
+    all.insert(all.end(), v.begin(), v.end());
+  std::sort(all.begin(), all.end());
+  BOOST_CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+  BOOST_CHECK_EQUAL(all.size(), nThreads * n);
+  //R3 checks upon destruction that all its points were unregistered
+}
@@ -0,0 +1,185 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+
+#include <manifolds/defs.h>
+#include <manifolds/utils.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/CartesianPower.h>
+#include <manifolds/Oblique.h>
+#include <manifolds/Point.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/Sn.h>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+BOOST_AUTO_TEST_CASE(ObliqueConstructor)
+{
+  Oblique O(3, 5);
+  BOOST_CHECK_EQUAL(O.dim(), 10);
+  BOOST_CHECK_EQUAL(O.tangentDim(), 15);
+  BOOST_CHECK_EQUAL(O.representationDim(), 15);
+  BOOST_CHECK_EQUAL(O.vectorDim(), 3);
+  BOOST_CHECK_EQUAL(O.numberOfVectors(), 5);
+  BOOST_CHECK(O.isElementary());
+
+  Eigen::MatrixXd zero = Eigen::MatrixXd::Zero(3, 5);
+  zero.row(0).setOnes();
+  BOOST_CHECK_EQUAL(O.getZero().value(), Eigen::Map<Eigen::VectorXd>(zero.data(), 15));
+  Point x = O.createRandomPoint();
+  BOOST_CHECK(x.isInM());
+  x.value()[14] += 0.1;
+  BOOST_CHECK(!x.isInM());
+  BOOST_CHECK_EQUAL(O.getTypeId(), Oblique(4, 2).getTypeId());
+  BOOST_CHECK(O.getTypeId() != Sn(2).getTypeId());
+}
+
+BOOST_AUTO_TEST_CASE(ObliqueMatchesCartesianPower)
+{
+  const Index k = 4, n = 6;
+  Oblique O(k, n);
+  Sn S(k - 1);
+  CartesianPower P(S, static_cast<int>(n));
+  BOOST_CHECK_EQUAL(O.dim(), P.dim());
+  BOOST_CHECK_EQUAL(O.tangentDim(), P.tangentDim());
+
+  Eigen::VectorXd x = O.createRandomPoint().value();
+  Eigen::VectorXd y = O.createRandomPoint().value();
+  BOOST_CHECK(P.isInM(x));
+  Eigen::VectorXd v = Eigen::VectorXd::Random(k*n);
+  O.forceOnTxM(v, v, x);
+  Eigen::VectorXd vP = Eigen::VectorXd::Random(k*n);
+  P.forceOnTxM(vP, v, x);
+  BOOST_CHECK(vP.isApprox(v));
+
+  Eigen::VectorXd rO(k*n), rP(k*n);
+  O.retractation(rO, x, v);
+  P.retractation(rP, x, v);
+  BOOST_CHECK(rO.isApprox(rP, 1e-12));
+
+  Eigen::VectorXd lO(k*n), lP(k*n);
+  O.pseudoLog(lO, x, y);
+  P.pseudoLog(lP, x, y);
+  BOOST_CHECK(lO.isApprox(lP, 1e-12));
+  O.pseudoLog0(lO, x);
+  P.pseudoLog0(lP, x);
+  BOOST_CHECK(lO.isApprox(lP, 1e-12));
+
+  BOOST_CHECK(O.diffRetractation(x).isApprox(P.diffRetractation(x)));
+  BOOST_CHECK(O.diffPseudoLog0(x).isApprox(P.diffPseudoLog0(x)));
+
+  Eigen::MatrixXd J = Eigen::MatrixXd::Random(7, k*n);
+  Eigen::MatrixXd JO(7, k*n), JP(7, k*n);
+  O.applyDiffRetractation(JO, J, x);
+  P.applyDiffRetractation(JP, J, x);
+  BOOST_CHECK(JO.isApprox(JP));
+  O.applyDiffPseudoLog0(JO, J, x);
+  P.applyDiffPseudoLog0(JP, J, x);
+  BOOST_CHECK(JO.isApprox(JP));
+  O.applyInvTransport(JO, J, x, v);
+  P.applyInvTransport(JP, J, x, v);
+  BOOST_CHECK(JO.isApprox(JP));
+
+  Eigen::MatrixXd H = Eigen::MatrixXd::Random(k*n, 3);
+  Eigen::MatrixXd HO(k*n, 3), HP(k*n, 3);
+  O.applyTransport(HO, H, x, v);
+  P.applyTransport(HP, H, x, v);
+  BOOST_CHECK(HO.isApprox(HP));
+
+  Eigen::MatrixXd CO(n, k*n), CP(n, k*n);
+  O.tangentConstraint(CO, x);
+  P.tangentConstraint(CP, x);
+  BOOST_CHECK(CO.isApprox(CP));
+  BOOST_CHECK((CO*v).isZero(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(ObliqueBatch)
+{
+  Oblique O(3, 4);
+  const Index N = 20;
+  PointSet X(O);
+  Eigen::MatrixXd v(12, N);
+  for (Index j = 0; j < N; ++j)
+  {
+    X.push_back(O.createRandomPoint().value());
+    Eigen::VectorXd vj = Eigen::VectorXd::Random(12);
+    O.forceOnTxM(v.col(j), vj, X[j].value());
+  }
+
+  PointSet Y(O);
+  X.retractation(Y, v);
+  for (Index j = 0; j < N; ++j)
+    BOOST_CHECK(Y[j].value().isApprox((Point(X[j]) + v.col(j)).value()));
+
+  //non-contiguous columns
+  Eigen::MatrixXd Z(14, N);
+  O.batchRetractation(Z.topRows(12), X.values(), v);
+  BOOST_CHECK(Z.topRows(12).isApprox(Y.values()));
+
+  PointSet S(X);
+  S.setLayout(PointSet::StructureOfArrays);
+  Eigen::MatrixXd vt = v.transpose();
+  S.increment(vt);
+  BOOST_CHECK(S.values().isApprox(Y.values().transpose()));
+}
+
+#if   EIGEN_WORLD_VERSION > 3 \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(ObliqueNoAllocation)
+{
+  const int r = 50;
+  Oblique O(3, 10);
+  Index t = O.tangentDim();
+  Eigen::VectorXd x = O.createRandomPoint().value();
+  Eigen::VectorXd y = O.createRandomPoint().value();
+  Eigen::VectorXd p = Eigen::VectorXd::Random(t);
+  O.forceOnTxM(p, p, x);
+  Eigen::VectorXd z(t);
+  Eigen::VectorXd d(t);
+  Eigen::MatrixXd J0 = Eigen::MatrixXd::Random(r, t);
+  Eigen::MatrixXd J1(r, t);
+  Eigen::MatrixXd J2(r, t);
+  Eigen::MatrixXd H0 = Eigen::MatrixXd::Random(t, 5);
+  Eigen::MatrixXd H1(t, 5);
+
+  O.applyDiffRetractation(J1, J0, x);
+  O.applyDiffPseudoLog0(J2, J1, x);
+  O.applyTransport(H1, H0, x, p);
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  utils::set_is_malloc_allowed(false);
+  {
+    O.retractation(z, x, p);
+    O.pseudoLog(d, y, x);
+    O.pseudoLog0(d, x);
+    O.applyDiffRetractation(J1, J0, x);
+    O.applyDiffPseudoLog0(J2, J1, x);
+    O.applyTransport(H1, H0, x, p);
+    O.applyInvTransport(J1, J0, x, p);
+  }
+  utils::set_is_malloc_allowed(true);
+  Eigen::internal::set_is_malloc_allowed(true);
+}
+#endif
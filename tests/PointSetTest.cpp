@@ -0,0 +1,201 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifold 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+#include <manifolds/defs.h>
+#include <manifolds/Point.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/RealSpace.h>
+#include <manifolds/S2.h>
+#include <manifolds/SO3.h>
+#include <manifolds/ExpMapMatrix.h>
+#include <manifolds/ExpMapQuaternion.h>
+#include <manifolds/CartesianProduct.h>
+
+using namespace mnf;
+
+BOOST_AUTO_TEST_CASE(PointSetConstructor)
+{
+  SO3<ExpMapQuaternion> RotSpace;
+  PointSet S(RotSpace, 5);
+  BOOST_CHECK_EQUAL(S.size(), 5);
+  BOOST_CHECK_EQUAL(S.values().rows(), 4);
+  BOOST_CHECK(S.isInM());
+  for (Index i = 0; i < S.size(); ++i)
+    BOOST_CHECK_EQUAL(S[i].value(), RotSpace.getZero().value());
+
+  //the values are stored one after the other
+  BOOST_CHECK_EQUAL(S[1].value().data(), S[0].value().data() + 4);
+
+  S.reserve(20);
+  BOOST_CHECK_EQUAL(S.capacity(), 20);
+  BOOST_CHECK_EQUAL(S.size(), 5);
+  S.resize(8);
+  BOOST_CHECK_EQUAL(S.size(), 8);
+  BOOST_CHECK_EQUAL(S[7].value(), RotSpace.getZero().value());
+
+  Point x = RotSpace.createRandomPoint();
+  S.push_back(x.value());
+  BOOST_CHECK_EQUAL(S.size(), 9);
+  BOOST_CHECK_EQUAL(S[8].value(), x.value());
+
+  PointSet C(S);
+  BOOST_CHECK_EQUAL(C.values(), S.values());
+  S.clear();
+  BOOST_CHECK(S.empty());
+  BOOST_CHECK_EQUAL(S.capacity(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(PointSetIteration)
+{
+  RealSpace R3(3);
+  PointSet S(R3, 4);
+  Index i = 0;
+  for (PointSet::iterator it = S.begin(); it != S.end(); ++it, ++i)
+    (*it).value().setConstant(static_cast<double>(i));
+  const PointSet& cS = S;
+  i = 0;
+  for (PointSet::const_iterator it = cS.begin(); it != cS.end(); ++it, ++i)
+    BOOST_CHECK_EQUAL((*it).value(), Eigen::Vector3d::Constant(static_cast<double>(i)));
+  BOOST_CHECK_EQUAL(i, 4);
+}
+
+BOOST_AUTO_TEST_CASE(PointSetBulkOperations)
+{
+  RealSpace R3(3);
+  SO3<ExpMapMatrix> RotSpace;
+  CartesianProduct P(R3, RotSpace);
+  const Index n = 7;
+  PointSet S(P);
+  std::vector<Point> points;
+  for (Index j = 0; j < n; ++j)
+  {
+    points.push_back(P.createRandomPoint());
+    S.push_back(points.back().value());
+  }
+  Eigen::MatrixXd v = Eigen::MatrixXd::Random(6, n);
+
+  PointSet T(P);
+  S.retractation(T, v);
+  BOOST_CHECK_EQUAL(T.size(), n);
+  BOOST_CHECK(T.isInM());
+  for (Index j = 0; j < n; ++j)
+    BOOST_CHECK(T[j].value().isApprox((points[static_cast<size_t>(j)] + v.col(j)).value()));
+
+  Eigen::MatrixXd w(6, n);
+  S.pseudoLog(w, T);
+  BOOST_CHECK(w.isApprox(v));
+
+  S.increment(v);
+  BOOST_CHECK_EQUAL(S.values(), T.values());
+
+  Eigen::MatrixXd l(6, n);
+  S.pseudoLog0(l);
+  for (Index j = 0; j < n; ++j)
+    BOOST_CHECK(l.col(j).isApprox(P.getZero().pseudoLog(Point(S[j]))));
+}
+
+namespace
+{
+  //Increments the same points in both layouts and compares the results
+  void checkStructureOfArrays(const Manifold& M, Index n)
+  {
+    PointSet A(M);
+    for (Index j = 0; j < n; ++j)
+      A.push_back(M.createRandomPoint().value());
+    Eigen::MatrixXd v = 0.5*Eigen::MatrixXd::Random(M.tangentDim(), n);
+    for (Index j = 0; j < n; ++j)
+      M.forceOnTxM(v.col(j), v.col(j), A[j].value());
+
+    PointSet S(A);
+    S.setLayout(PointSet::StructureOfArrays);
+    BOOST_CHECK_EQUAL(S.layout(), PointSet::StructureOfArrays);
+    BOOST_CHECK_EQUAL(S.values(), A.values().transpose());
+    BOOST_CHECK_EQUAL(S.getPoint(n-1).value(), A[n-1].value());
+
+    PointSet A0(A), S0(S);
+    A.increment(v);
+    Eigen::MatrixXd vt = v.transpose();
+    S.increment(vt);
+    BOOST_CHECK(S.isInM());
+    BOOST_CHECK(S.values().isApprox(A.values().transpose()));
+
+    Eigen::MatrixXd l(n, M.tangentDim());
+    S0.pseudoLog(l, S);
+    Eigen::MatrixXd lA(M.tangentDim(), n);
+    A0.pseudoLog(lA, A);
+    BOOST_CHECK(l.isApprox(lA.transpose()));
+
+    S.setLayout(PointSet::ArrayOfStructures);
+    BOOST_CHECK(S.values().isApprox(A.values()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PointSetStructureOfArrays)
+{
+  RealSpace R3(3);
+  S2 Sphere;
+  SO3<ExpMapQuaternion> RotQuat;
+  SO3<ExpMapMatrix> RotMat;
+  CartesianProduct P(R3, RotMat);
+  checkStructureOfArrays(R3, 11);
+  checkStructureOfArrays(Sphere, 11);
+  checkStructureOfArrays(RotQuat, 11);
+  checkStructureOfArrays(RotMat, 11);
+  checkStructureOfArrays(P, 5);
+
+  PointSet S(RotQuat, 3, PointSet::StructureOfArrays);
+  BOOST_CHECK_EQUAL(S.values().rows(), 3);
+  BOOST_CHECK_EQUAL(S.values().cols(), 4);
+  BOOST_CHECK(S.isInM());
+}
+
+#if   EIGEN_WORLD_VERSION > 3 \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(PointSetNoAllocation)
+{
+  SO3<ExpMapQuaternion> RotSpace;
+  PointSet S(RotSpace, 100);
+  Eigen::MatrixXd v = 0.1*Eigen::MatrixXd::Random(3, 100);
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  {
+    S.increment(v);
+    S.resize(50);
+    S.increment(v.leftCols(50));
+    BOOST_CHECK(S.isInM());
+  }
+  Eigen::internal::set_is_malloc_allowed(true);
+
+  S.setLayout(PointSet::StructureOfArrays);
+  Eigen::MatrixXd vt = v.leftCols(50).transpose();
+  Eigen::internal::set_is_malloc_allowed(false);
+  {
+    S.increment(vt);
+  }
+  Eigen::internal::set_is_malloc_allowed(true);
+  BOOST_CHECK(S.isInM());
+}
+#endif
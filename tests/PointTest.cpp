@@ -26,6 +26,7 @@
 #include <manifolds/defs.h>
 #include <manifolds/utils.h>
 #include <manifolds/Point.h>
+#include <manifolds/PointArena.h>
 #include <manifolds/RealSpace.h>
 #include <manifolds/SO3.h>
 #include <manifolds/ExpMapMatrix.h>
@@ -264,6 +265,44 @@ BOOST_AUTO_TEST_CASE(SO3ApplyInvDiff)
   BOOST_CHECK(expectedRes.isApprox(J));
 }
 
+BOOST_AUTO_TEST_CASE(PointArenaAllocation)
+{
+  RealSpace R3(3);
+  SO3<ExpMapMatrix> RotSpace;
+  CartesianProduct S(R3, RotSpace);
+  PointArena arena(64);
+  {
+    Point x = S.getZero(arena);
+    Point y = S.createRandomPoint(arena);
+    BOOST_CHECK(x.isInM());
+    BOOST_CHECK(y.isInM());
+    BOOST_CHECK_EQUAL(x.value(), S.getZero().value());
+
+    //12 doubles, rounded to 12, for each point
+    BOOST_CHECK_EQUAL(arena.used(), 24);
+    BOOST_CHECK_EQUAL(arena.capacity(), 64);
+
+    Eigen::VectorXd v = Eigen::VectorXd::Random(6);
+    Point z = x + v;
+    Point w = y.retractation(v);
+    Point c(w);
+    BOOST_CHECK_EQUAL(arena.used(), 60);
+    BOOST_CHECK(z.value().isApprox((S.getZero() + v).value()));
+    BOOST_CHECK_EQUAL(c.value(), w.value());
+
+    //does not fit in the first chunk
+    Point u = S.createPoint(y.value(), arena);
+    BOOST_CHECK_EQUAL(u.value(), y.value());
+    BOOST_CHECK_EQUAL(arena.capacity(), 128);
+    BOOST_CHECK(x.value().data() != u.value().data());
+  }
+  arena.clear();
+  BOOST_CHECK_EQUAL(arena.used(), 0);
+  BOOST_CHECK_EQUAL(arena.capacity(), 128);
+  arena.release();
+  BOOST_CHECK_EQUAL(arena.capacity(), 0);
+}
+
 #if   EIGEN_WORLD_VERSION > 3 \
   || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
   || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
@@ -298,5 +337,118 @@ BOOST_AUTO_TEST_CASE(PointNoAllocation)
   Eigen::internal::set_is_malloc_allowed(true);
 }
 
+BOOST_AUTO_TEST_CASE(PointInlineStorage)
+{
+  SO3<ExpMapMatrix> RotSpace;
+  RealSpace R3(3);
+  CartesianProduct S(R3, RotSpace);
+  RealSpace R20(20);
+  Point x = RotSpace.getZero();
+  Point y = R20.getZero();
+  Eigen::Vector3d v = Eigen::Vector3d::Ones();
+
+  //values of small manifolds are stored in the point itself
+  const char* begin = reinterpret_cast<const char*>(&x);
+  const char* data = reinterpret_cast<const char*>(x.value().data());
+  BOOST_CHECK(data >= begin && data < begin + sizeof(Point));
+  begin = reinterpret_cast<const char*>(&y);
+  data = reinterpret_cast<const char*>(y.value().data());
+  BOOST_CHECK(!(data >= begin && data < begin + sizeof(Point)));
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  {
+    Point z = RotSpace.getZero();
+    Point w = z.retractation(v);
+    Point c(w);
+    Point s = S.createRandomPoint();
+    BOOST_CHECK(w.isInM());
+    BOOST_CHECK_EQUAL(c.value(), w.value());
+    BOOST_CHECK(s.isInM());
+  }
+  Eigen::internal::set_is_malloc_allowed(true);
+}
+
+BOOST_AUTO_TEST_CASE(PointMove)
+{
+  RealSpace R20(20);
+  Eigen::VectorXd v = Eigen::VectorXd::Ones(20);
+  Eigen::VectorXd mv = -v;
+  Point x = R20.getZero();
+  Point y = R20.createPoint(v);
+  const double* dx = x.value().data();
+  const double* dy = y.value().data();
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  {
+    //the heap buffer is taken over
+    Point z(std::move(x));
+    BOOST_CHECK_EQUAL(z.value().data(), dx);
+    BOOST_CHECK_EQUAL(x.value().size(), 0);
+
+    //move assignment swaps the buffers
+    z = std::move(y);
+    BOOST_CHECK_EQUAL(z.value().data(), dy);
+    BOOST_CHECK_EQUAL(y.value().data(), dx);
+    BOOST_CHECK_EQUAL(z.value(), v);
+
+    //chained increments on an rvalue work in place
+    Point w = std::move(z) + v + v;
+    BOOST_CHECK_EQUAL(w.value().data(), dy);
+    BOOST_CHECK_EQUAL(w.value(), 3*v);
+
+    //so do increments on an rvalue
+    Point u = std::move(w).increment(v).increment(mv);
+    BOOST_CHECK_EQUAL(u.value().data(), dy);
+    BOOST_CHECK_EQUAL(u.value(), 3*v);
+    y = std::move(u);
+  }
+  Eigen::internal::set_is_malloc_allowed(true);
+
+  //a moved-from point can be assigned to again
+  x = y;
+  BOOST_CHECK_EQUAL(x.value(), 3*v);
+  BOOST_CHECK(x.value().data() != y.value().data());
+
+  //same with points whose memory is in an arena
+  RealSpace R3(3);
+  PointArena arena;
+  Point a = R3.createPoint(Eigen::Vector3d(1, 2, 3), arena);
+  Point c = R3.createPoint(Eigen::Vector3d(7, 8, 9), arena);
+  const double* da = a.value().data();
+  Point b(std::move(a));
+  BOOST_CHECK_EQUAL(b.value().data(), da);
+  BOOST_CHECK_EQUAL(a.value().size(), 0);
+  a = c;
+  BOOST_CHECK_EQUAL(b.value(), Eigen::Vector3d(1, 2, 3));
+  BOOST_CHECK_EQUAL(a.value(), Eigen::Vector3d(7, 8, 9));
+  BOOST_CHECK(a.value().data() != b.value().data());
+
+  Point d = std::move(b) + Eigen::Vector3d::Ones();
+  b = c;
+  BOOST_CHECK_EQUAL(d.value(), Eigen::Vector3d(2, 3, 4));
+  BOOST_CHECK_EQUAL(b.value(), Eigen::Vector3d(7, 8, 9));
+}
+
+BOOST_AUTO_TEST_CASE(PointArenaNoAllocation)
+{
+  RealSpace R3(3);
+  PointArena arena;
+  Eigen::Vector3d v = Eigen::Vector3d::Ones();
+  { Point p = R3.createPoint(arena); }
+  arena.clear();
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      Point x = R3.getZero(arena);
+      Point y = x.retractation(v);
+      BOOST_CHECK_EQUAL(y.value()[0], 1);
+    }
+  }
+  Eigen::internal::set_is_malloc_allowed(true);
+  arena.clear();
+}
+
 #endif
 
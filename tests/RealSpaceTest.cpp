@@ -22,6 +22,9 @@
 #include <manifolds/utils.h>
 #include <manifolds/mnf_assert.h>
 #include <manifolds/RealSpace.h>
+#include <manifolds/SO3.h>
+#include <manifolds/ExpMapMatrix.h>
+#include <manifolds/CartesianProduct.h>
 #include <manifolds/Point.h>
 
 #ifndef _WIN32
@@ -197,6 +200,29 @@ BOOST_AUTO_TEST_CASE(RealInvTransport)
   BOOST_CHECK(expectedRes.isApprox(Hout));
 }
 
+BOOST_AUTO_TEST_CASE(RealIdentityJacobians)
+{
+  RealSpace R(5);
+  SO3<ExpMapMatrix> RotSpace;
+  CartesianProduct P(R, RotSpace);
+  BOOST_CHECK(R.hasIdentityJacobians());
+  BOOST_CHECK(!RotSpace.hasIdentityJacobians());
+  BOOST_CHECK(!P.hasIdentityJacobians());
+  BOOST_CHECK(CartesianProduct(R, R).hasIdentityJacobians());
+
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  BlockDiagonalMatrix J = P.diffRetractationBlocks(x);
+  BOOST_CHECK(J.isIdentityBlock(0));
+  BOOST_CHECK(!J.isIdentityBlock(1));
+  BOOST_CHECK(J.toDense().isApprox(P.diffRetractation(x)));
+
+  //in-place application: nothing to do
+  Eigen::MatrixXd A = Eigen::MatrixXd::Random(3, 5);
+  Eigen::MatrixXd B = A;
+  R.applyDiffRetractation(A, A, x.head(5));
+  BOOST_CHECK_EQUAL(A, B);
+}
+
 BOOST_AUTO_TEST_CASE(RealLimitMap)
 {
   RealSpace Space(9);
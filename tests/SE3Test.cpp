@@ -0,0 +1,264 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+
+#include <manifolds/defs.h>
+#include <manifolds/utils.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/SE3.h>
+#include <manifolds/SO3.h>
+#include <manifolds/Point.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/RealSpace.h>
+#include <manifolds/ExpMapMatrix.h>
+#include <manifolds/ExpMapQuaternion.h>
+#include <manifolds/StaticCartesianProduct.h>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+BOOST_AUTO_TEST_CASE(SE3Constructor)
+{
+  SE3<ExpMapQuaternion> SQ;
+  SE3<ExpMapMatrix> SM;
+  BOOST_CHECK_EQUAL(SQ.dim(), 6);
+  BOOST_CHECK_EQUAL(SQ.tangentDim(), 6);
+  BOOST_CHECK_EQUAL(SQ.representationDim(), 7);
+  BOOST_CHECK_EQUAL(SM.representationDim(), 12);
+  BOOST_CHECK(SQ.isElementary());
+  BOOST_CHECK_EQUAL(SQ.numberOfSubmanifolds(), 1);
+
+  Eigen::VectorXd zero(7);
+  zero << 0, 0, 0, 0, 0, 0, 1;
+  BOOST_CHECK_EQUAL(SQ.getZero().value(), zero);
+  BOOST_CHECK(SM.getZero().isInM());
+  BOOST_CHECK(SQ.createRandomPoint().isInM());
+
+  SO3<ExpMapQuaternion> RQ;
+  BOOST_CHECK(SQ.getTypeId() != SM.getTypeId());
+  BOOST_CHECK(SQ.getTypeId() != RQ.getTypeId());
+  BOOST_CHECK_EQUAL(SQ.getTypeId(), SE3<ExpMapQuaternion>(2., 1.).getTypeId());
+
+  Eigen::VectorXd limit(6);
+  SQ.limitMap(limit);
+  BOOST_CHECK(std::isinf(limit[0]));
+  BOOST_CHECK_CLOSE(limit[5], M_PI/sqrt(3), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(SE3Retractation)
+{
+  SE3<ExpMapQuaternion> SQ;
+  SE3<ExpMapMatrix> SM;
+
+  //screw motion around z from the identity:
+  //exp(nu, w) = (Rz(a), [sin(a)/a, (1-cos(a))/a, 0]*nu_x)
+  double a = 1.2;
+  Eigen::VectorXd v(6);
+  v << 0.5, 0, 0, 0, 0, a;
+  Eigen::VectorXd x = SM.getZero().value();
+  SM.retractation(x, x, v);
+  Eigen::Vector3d t(0.5*sin(a)/a, 0.5*(1 - cos(a))/a, 0);
+  BOOST_CHECK(x.head(3).isApprox(t));
+  Eigen::Matrix3d Rz(Eigen::AngleAxisd(a, Eigen::Vector3d::UnitZ()));
+  BOOST_CHECK(Eigen::Map<const Eigen::Matrix3d>(x.data() + 3).isApprox(Rz));
+
+  //both representations give the same transformation, and the rotation
+  //part is the one of SO3
+  SO3<ExpMapQuaternion> RQ;
+  Point xQ = SQ.createRandomPoint();
+  Eigen::VectorXd xM(12);
+  xM.head(3) = xQ.value().head(3);
+  Eigen::Map<Eigen::Matrix3d>(xM.data() + 3) = ExpMapQuaternion::rotationMatrix(xQ.value().tail(4));
+  for (int i = 0; i < 10; ++i)
+  {
+    v = Eigen::VectorXd::Random(6);
+    Point yQ = xQ + v;
+    Eigen::VectorXd yM(12);
+    SM.retractation(yM, xM, v);
+    BOOST_CHECK(yQ.isInM());
+    BOOST_CHECK(yQ.value().head(3).isApprox(yM.head(3)));
+    BOOST_CHECK(ExpMapQuaternion::rotationMatrix(yQ.value().tail(4)).isApprox(Eigen::Map<const Eigen::Matrix3d>(yM.data() + 3)));
+    Eigen::Vector4d r;
+    RQ.retractation(r, xQ.value().tail(4), v.tail(3));
+    BOOST_CHECK(r.isApprox(yQ.value().tail(4)));
+  }
+
+  //a pure translation is expressed in the local frame
+  v << 0.1, 0.2, 0.3, 0, 0, 0;
+  Point yQ = xQ + v;
+  BOOST_CHECK(yQ.value().head(3).isApprox(xQ.value().head(3) + ExpMapQuaternion::rotationMatrix(xQ.value().tail(4))*v.head(3)));
+}
+
+namespace
+{
+  template<typename Map>
+  void checkPseudoLog(double angle)
+  {
+    SE3<Map> S;
+    Point x = S.createRandomPoint();
+    Eigen::VectorXd v = Eigen::VectorXd::Random(6);
+    v.tail(3) *= angle/v.tail(3).norm();
+    Point y = x + v;
+    Eigen::VectorXd l(6);
+    S.pseudoLog(l, x.value(), y.value());
+    BOOST_CHECK(l.isApprox(v, 1e-7));
+    Point z = S.getZero() + v;
+    S.pseudoLog0(l, z.value());
+    BOOST_CHECK(l.isApprox(v, 1e-7));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SE3PseudoLog)
+{
+  //the angles go through the small-angle expansions, their switch value and
+  //the closed forms up to pi
+  double angles[] = {1e-9, 1e-4, 0.1, sqrt(0.1), 0.5, 2., 3.1};
+  for (double a : angles)
+  {
+    checkPseudoLog<ExpMapQuaternion>(a);
+    checkPseudoLog<ExpMapMatrix>(a);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SE3Diff)
+{
+  double h = 1e-7;
+  SE3<ExpMapQuaternion> S;
+  Point x = S.createRandomPoint();
+  Eigen::MatrixXd J(7, 6);
+  Eigen::VectorXd y(7);
+  for (Index i = 0; i < 6; ++i)
+  {
+    Eigen::VectorXd dv = Eigen::VectorXd::Zero(6);
+    dv[i] = h;
+    S.retractation(y, x.value(), dv);
+    J.col(i) = (y - x.value())/h;
+  }
+  BOOST_CHECK(J.isApprox(S.diffRetractation(x.value()), 1e-5));
+
+  //the log is differentiated with respect to the 7 coefficients of x, the
+  //closed form of the quaternion log not requiring a unit quaternion
+  Eigen::MatrixXd JL(6, 7);
+  Eigen::VectorXd l0(6), l(6);
+  S.pseudoLog0(l0, x.value());
+  for (Index i = 0; i < 7; ++i)
+  {
+    Eigen::VectorXd xi = x.value();
+    xi[i] += h;
+    S.pseudoLog0(l, xi);
+    JL.col(i) = (l - l0)/h;
+  }
+  BOOST_CHECK(JL.isApprox(S.diffPseudoLog0(x.value()), 1e-5));
+
+  Eigen::MatrixXd Jf = Eigen::MatrixXd::Random(5, 7);
+  Eigen::MatrixXd out(5, 6);
+  S.applyDiffRetractation(out, Jf, x.value());
+  BOOST_CHECK(out.isApprox(Jf*S.diffRetractation(x.value())));
+  Eigen::MatrixXd Jg = Eigen::MatrixXd::Random(5, 6);
+  Eigen::MatrixXd out2(5, 7);
+  S.applyDiffPseudoLog0(out2, Jg, x.value());
+  BOOST_CHECK(out2.isApprox(Jg*S.diffPseudoLog0(x.value())));
+
+  SE3<ExpMapMatrix> SM;
+  Point xM = SM.createRandomPoint();
+  Eigen::MatrixXd JfM = Eigen::MatrixXd::Random(5, 12);
+  SM.applyDiffRetractation(out, JfM, xM.value());
+  BOOST_CHECK(out.isApprox(JfM*SM.diffRetractation(xM.value())));
+  Eigen::MatrixXd out3(5, 12);
+  SM.applyDiffPseudoLog0(out3, Jg, xM.value());
+  BOOST_CHECK(out3.isApprox(Jg*SM.diffPseudoLog0(xM.value())));
+}
+
+BOOST_AUTO_TEST_CASE(SE3Batch)
+{
+  SE3<ExpMapQuaternion> SQ;
+  SE3<ExpMapMatrix> SM;
+  const Manifold* manifolds[] = {&SQ, &SM};
+  for (const Manifold* M : manifolds)
+  {
+    const Index n = 13;
+    PointSet X(*M);
+    for (Index j = 0; j < n; ++j)
+      X.push_back(M->createRandomPoint().value());
+    Eigen::MatrixXd v = Eigen::MatrixXd::Random(6, n);
+    PointSet Y(*M);
+    X.retractation(Y, v);
+    for (Index j = 0; j < n; ++j)
+      BOOST_CHECK(Y[j].value().isApprox((Point(X[j]) + v.col(j)).value()));
+
+    PointSet S(X);
+    S.setLayout(PointSet::StructureOfArrays);
+    Eigen::MatrixXd vt = v.transpose();
+    S.increment(vt);
+    BOOST_CHECK(S.values().isApprox(Y.values().transpose()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SE3InStaticProduct)
+{
+  typedef StaticCartesianProduct<RealSpaceN<2>, SE3<ExpMapQuaternion> > Prod;
+  Prod P;
+  BOOST_CHECK_EQUAL(P.representationDim(), 9);
+  BOOST_CHECK_EQUAL(P.tangentDim(), 8);
+  Point x = P.createRandomPoint();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(8);
+  Point y = x + v;
+  SE3<ExpMapQuaternion> S;
+  Eigen::VectorXd z(7);
+  S.retractation(z, x.value().tail(7), v.tail(6));
+  BOOST_CHECK(y.value().tail(7).isApprox(z));
+  BOOST_CHECK(y.value().head(2).isApprox(x.value().head(2) + v.head(2)));
+}
+
+#if   EIGEN_WORLD_VERSION > 3 \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(SE3NoAllocation)
+{
+  const int r = 100;
+  SE3<ExpMapQuaternion> S;
+  Eigen::VectorXd x = S.createRandomPoint().value();
+  Eigen::VectorXd y = S.createRandomPoint().value();
+  Eigen::VectorXd p = Eigen::VectorXd::Random(6);
+  Eigen::VectorXd z(7);
+  Eigen::VectorXd d(6);
+  Eigen::MatrixXd J0 = Eigen::MatrixXd::Random(r, 7);
+  Eigen::MatrixXd J1(r, 6);
+  Eigen::MatrixXd J2(r, 7);
+
+  S.applyDiffRetractation(J1, J0, x);
+  S.applyDiffPseudoLog0(J2, J1, x);
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  utils::set_is_malloc_allowed(false);
+  {
+    S.retractation(z, x, p);
+    S.pseudoLog(d, y, x);
+    S.pseudoLog0(d, x);
+    S.applyDiffRetractation(J1, J0, x);
+    S.applyDiffPseudoLog0(J2, J1, x);
+  }
+  utils::set_is_malloc_allowed(true);
+  Eigen::internal::set_is_malloc_allowed(true);
+}
+#endif
@@ -17,6 +17,8 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
@@ -310,6 +312,77 @@ BOOST_AUTO_TEST_CASE(SO3ApplyInvDiff)
 //  BOOST_CHECK(expectedRes.isApprox(Hout));
 //}
 
+BOOST_AUTO_TEST_CASE(SO3SharedAcrossThreads)
+{
+  //Several threads evaluate Jacobians with the same SO3 instance. Each
+  //thread uses its own temporary buffer, so that the results are not
+  //corrupted.
+  const int nThreads = 4;
+  const int c = 50;
+  SO3<ExpMapMatrix> S;
+  std::vector<Eigen::VectorXd> x(nThreads);
+  std::vector<Eigen::MatrixXd> Jf(nThreads), expected(nThreads), J(nThreads);
+  for (int k = 0; k < nThreads; ++k)
+  {
+    x[k] = S.createRandomPoint().value();
+    Jf[k] = Eigen::MatrixXd::Random(c, S.representationDim());
+    expected[k] = Jf[k]*S.diffRetractation(x[k]);
+    J[k].resize(c, S.dim());
+  }
+
+  std::vector<std::thread> threads;
+  for (int k = 0; k < nThreads; ++k)
+  {
+    threads.push_back(std::thread([&, k]()
+    {
+      for (int i = 0; i < 1000; ++i)
+        S.applyDiffRetractation(J[k], Jf[k], x[k]);
+    }));
+  }
+  for (auto& t : threads)
+    t.join();
+
+  for (int k = 0; k < nThreads; ++k)
+    BOOST_CHECK(expected[k].isApprox(J[k]));
+}
+
+BOOST_AUTO_TEST_CASE(SO3BatchExpLog)
+{
+  const Eigen::DenseIndex N = 29;
+  SO3<ExpMapMatrix> S;
+  Eigen::MatrixXd V = Eigen::MatrixXd::Random(3, N);
+  V.col(0).setZero();
+  V.col(1) << 1e-6, -2e-5, 3e-7;
+  V.col(2) << 1.7, -1.7, 1.7;
+  Eigen::MatrixXd X(9, N);
+  for (Eigen::DenseIndex j = 0; j < N; ++j)
+    S.createRandomPoint(X.col(j));
+
+  Eigen::MatrixXd E(9, N);
+  ExpMapMatrix::batchExponential(E, V);
+  Eigen::MatrixXd L(3, N);
+  ExpMapMatrix::batchLogarithm(L, E);
+  Eigen::MatrixXd Y(9, N);
+  S.batchRetractation(Y, X, V);
+  Eigen::Matrix3d e;
+  Eigen::VectorXd y(9);
+  for (Eigen::DenseIndex j = 0; j < N; ++j)
+  {
+    ExpMapMatrix::exponential(e, V.col(j));
+    BOOST_CHECK(toMat3(E.col(j).data()).isApprox(e, 1e-14));
+    BOOST_CHECK((L.col(j) - V.col(j)).norm() < 1e-12);
+    S.retractation(y, X.col(j), V.col(j));
+    BOOST_CHECK(y.isApprox(Y.col(j), 1e-14));
+  }
+
+  Eigen::MatrixXd Esoa(N, 9);
+  ExpMapMatrix::batchExponentialSoA(Esoa, V.transpose());
+  BOOST_CHECK(Esoa.isApprox(E.transpose()));
+  Eigen::MatrixXd Lsoa(N, 3);
+  ExpMapMatrix::batchLogarithmSoA(Lsoa, Esoa);
+  BOOST_CHECK(Lsoa.isApprox(L.transpose()));
+}
+
 #if   EIGEN_WORLD_VERSION > 3 \
   || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
   || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
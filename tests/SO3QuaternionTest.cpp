@@ -379,6 +379,32 @@ Eigen::Matrix<double,3,4> diffRotatePointQuaternion(Point& Qp, RefVec Pp)
   return res;
 }
 
+BOOST_AUTO_TEST_CASE(SO3BatchExponential)
+{
+  const Eigen::DenseIndex N = 37;
+  SO3<ExpMapQuaternion> S;
+  Eigen::MatrixXd V = Eigen::MatrixXd::Random(3, N);
+  V.col(0).setZero();
+  V.col(1) << 1e-6, -2e-5, 3e-7;
+  V.col(2) << 1.8, -1.8, 1.8;
+  Eigen::MatrixXd X(4, N);
+  for (Eigen::DenseIndex j = 0; j < N; ++j)
+    S.createRandomPoint(X.col(j));
+
+  Eigen::MatrixXd E(4, N);
+  ExpMapQuaternion::batchExponential(E, V);
+  Eigen::MatrixXd Y(4, N);
+  S.batchRetractation(Y, X, V);
+  Eigen::Vector4d q, y;
+  for (Eigen::DenseIndex j = 0; j < N; ++j)
+  {
+    ExpMapQuaternion::exponential(q, V.col(j));
+    BOOST_CHECK(q.isApprox(E.col(j), 1e-14));
+    S.retractation(y, X.col(j), V.col(j));
+    BOOST_CHECK(y.isApprox(Y.col(j), 1e-14));
+  }
+}
+
 BOOST_AUTO_TEST_CASE(SO3CompareMatrixQuaternion)
 {
   SO3<ExpMapMatrix> SO3_M;
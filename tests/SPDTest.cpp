@@ -0,0 +1,223 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+
+#include <manifolds/defs.h>
+#include <manifolds/utils.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/Point.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/SPD.h>
+
+#include <Eigen/Cholesky>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+BOOST_AUTO_TEST_CASE(SPDConstructor)
+{
+  SPD P(4);
+  BOOST_CHECK_EQUAL(P.dim(), 10);
+  BOOST_CHECK_EQUAL(P.tangentDim(), 10);
+  BOOST_CHECK_EQUAL(P.representationDim(), 10);
+  BOOST_CHECK_EQUAL(P.matrixSize(), 4);
+  BOOST_CHECK(P.isElementary());
+  BOOST_CHECK_EQUAL(P.packedIndex(3, 0), 3);
+  BOOST_CHECK_EQUAL(P.packedIndex(1, 1), 4);
+  BOOST_CHECK_EQUAL(P.packedIndex(3, 3), 9);
+
+  Eigen::MatrixXd S(4, 4);
+  P.toMatrix(S, P.getZero().value());
+  BOOST_CHECK(S.isIdentity());
+  Point x = P.createRandomPoint();
+  BOOST_CHECK(x.isInM());
+  x.value()[P.packedIndex(2, 2)] *= -1;
+  BOOST_CHECK(!x.isInM());
+  BOOST_CHECK_EQUAL(P.getTypeId(), SPD(2).getTypeId());
+}
+
+BOOST_AUTO_TEST_CASE(SPDCholesky)
+{
+  const Index n = 5;
+  SPD P(n);
+  Eigen::MatrixXd A = Eigen::MatrixXd::Random(n, n);
+  Eigen::MatrixXd S = A*A.transpose() + 0.1*Eigen::MatrixXd::Identity(n, n);
+  Eigen::VectorXd x(P.representationDim());
+  BOOST_CHECK(P.fromMatrix(x, S));
+  BOOST_CHECK(P.isInM(x));
+  Eigen::MatrixXd L = S.llt().matrixL();
+  for (Index j = 0; j < n; ++j)
+    for (Index i = j; i < n; ++i)
+      BOOST_CHECK_CLOSE(x[P.packedIndex(i, j)], L(i, j), 1e-10);
+  Eigen::MatrixXd S2(n, n);
+  P.toMatrix(S2, x);
+  BOOST_CHECK(S2.isApprox(S, 1e-12));
+
+  //not positive definite
+  Eigen::MatrixXd N = S;
+  N(2, 2) = -1;
+  BOOST_CHECK(!P.fromMatrix(x, N));
+
+  //flipping the sign of a column of L gives the same matrix
+  P.fromMatrix(x, S);
+  Eigen::VectorXd y = x;
+  y.segment(P.packedIndex(1, 1), n - 1) *= -1;
+  BOOST_CHECK(!P.isInM(y));
+  P.forceOnM(y, y);
+  BOOST_CHECK(y.isApprox(x));
+}
+
+BOOST_AUTO_TEST_CASE(SPDRetractationAndLog)
+{
+  SPD P(4);
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  Eigen::VectorXd y = P.createRandomPoint().value();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(10);
+  Eigen::VectorXd z(10), l(10);
+
+  P.retractation(z, x, v);
+  BOOST_CHECK(P.isInM(z));
+  P.pseudoLog(l, x, z);
+  BOOST_CHECK(l.isApprox(v, 1e-12));
+  P.pseudoLog(l, x, y);
+  P.retractation(z, x, l);
+  BOOST_CHECK(z.isApprox(y, 1e-12));
+  BOOST_CHECK_CLOSE(P.distance(x, y), P.distance(y, x), 1e-10);
+  BOOST_CHECK_SMALL(P.distance(x, x), 1e-14);
+
+  P.pseudoLog0(l, x);
+  P.retractation(z, P.getZero().value(), l);
+  BOOST_CHECK(z.isApprox(x, 1e-12));
+
+  //Log_I(sI) is log(sqrt(s)) on the diagonal and zero elsewhere
+  Eigen::MatrixXd S = 4*Eigen::MatrixXd::Identity(4, 4);
+  P.fromMatrix(z, S);
+  P.pseudoLog0(l, z);
+  BOOST_CHECK_CLOSE(l[P.packedIndex(3, 3)], log(2.0), 1e-10);
+  BOOST_CHECK_SMALL(l[P.packedIndex(3, 0)], 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(SPDDiff)
+{
+  SPD P(3);
+  const Index r = 6;
+  const double h = 1e-7;
+  Eigen::VectorXd x = P.createRandomPoint().value();
+
+  Eigen::MatrixXd J = P.diffRetractation(x);
+  Eigen::MatrixXd Jfd(r, r);
+  Eigen::VectorXd z0(r), z1(r);
+  for (Index i = 0; i < r; ++i)
+  {
+    Eigen::VectorXd v = Eigen::VectorXd::Zero(r);
+    v[i] = h;
+    P.retractation(z1, x, v);
+    Jfd.col(i) = (z1 - x)/h;
+  }
+  BOOST_CHECK(J.isApprox(Jfd, 1e-6));
+
+  Eigen::MatrixXd J0 = P.diffPseudoLog0(x);
+  P.pseudoLog0(z0, x);
+  for (Index i = 0; i < r; ++i)
+  {
+    Eigen::VectorXd xi = x;
+    xi[i] += h;
+    P.pseudoLog0(z1, xi);
+    Jfd.col(i) = (z1 - z0)/h;
+  }
+  BOOST_CHECK(J0.isApprox(Jfd, 1e-6));
+
+  Eigen::MatrixXd G = Eigen::MatrixXd::Random(4, r);
+  Eigen::MatrixXd out(4, r);
+  P.applyDiffPseudoLog0(out, G, x);
+  BOOST_CHECK(out.isApprox(G*J0));
+  P.applyDiffRetractation(out, G, x);
+  BOOST_CHECK(out.isApprox(G*J));
+
+  //transport and inverse transport cancel each other
+  Eigen::VectorXd v = Eigen::VectorXd::Random(r);
+  Eigen::MatrixXd H = Eigen::MatrixXd::Random(r, 2);
+  Eigen::MatrixXd T(r, 2);
+  P.applyTransport(T, H, x, v);
+  P.applyInvTransport(out, G, x, v);
+  BOOST_CHECK((out*T).isApprox(G*H));
+}
+
+BOOST_AUTO_TEST_CASE(SPDBatch)
+{
+  SPD P(3);
+  const Index N = 15;
+  PointSet X(P);
+  Eigen::MatrixXd v = Eigen::MatrixXd::Random(6, N);
+  for (Index j = 0; j < N; ++j)
+    X.push_back(P.createRandomPoint().value());
+
+  PointSet Y(P);
+  X.retractation(Y, v);
+  for (Index j = 0; j < N; ++j)
+    BOOST_CHECK(Y[j].value().isApprox((Point(X[j]) + v.col(j)).value()));
+
+  PointSet S(X);
+  S.setLayout(PointSet::StructureOfArrays);
+  Eigen::MatrixXd vt = v.transpose();
+  S.increment(vt);
+  BOOST_CHECK(S.values().isApprox(Y.values().transpose()));
+}
+
+#if   EIGEN_WORLD_VERSION > 3 \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(SPDNoAllocation)
+{
+  const int r = 50;
+  SPD P(6);
+  Index t = P.tangentDim();
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  Eigen::VectorXd y = P.createRandomPoint().value();
+  Eigen::VectorXd p = Eigen::VectorXd::Random(t);
+  Eigen::VectorXd z(t);
+  Eigen::VectorXd d(t);
+  Eigen::MatrixXd S(6, 6);
+  Eigen::MatrixXd J0 = Eigen::MatrixXd::Random(r, t);
+  Eigen::MatrixXd J1(r, t);
+  Eigen::MatrixXd J2(r, t);
+  Eigen::MatrixXd H0 = Eigen::MatrixXd::Random(t, 5);
+  Eigen::MatrixXd H1(t, 5);
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  utils::set_is_malloc_allowed(false);
+  {
+    P.retractation(z, x, p);
+    P.pseudoLog(d, y, x);
+    P.pseudoLog0(d, x);
+    P.toMatrix(S, z);
+    P.fromMatrix(z, S);
+    P.applyDiffRetractation(J1, J0, x);
+    P.applyDiffPseudoLog0(J2, J1, x);
+    P.applyTransport(H1, H0, x, p);
+    P.applyInvTransport(J1, J0, x, p);
+  }
+  utils::set_is_malloc_allowed(true);
+  Eigen::internal::set_is_malloc_allowed(true);
+}
+#endif
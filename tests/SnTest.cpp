@@ -0,0 +1,261 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include <manifolds/defs.h>
+#include <manifolds/utils.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/S2.h>
+#include <manifolds/Sn.h>
+#include <manifolds/Point.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/RealSpace.h>
+#include <manifolds/StaticCartesianProduct.h>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+namespace
+{
+  /// Random unit tangent vector at x
+  Eigen::VectorXd randomUnitTangent(const Sn& S, const ConstRefVec& x)
+  {
+    Eigen::VectorXd u = Eigen::VectorXd::Random(x.size());
+    S.forceOnTxM(u, u, x);
+    return u/u.norm();
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SnConstructor)
+{
+  Sn S(4);
+  BOOST_CHECK_EQUAL(S.dim(), 4);
+  BOOST_CHECK_EQUAL(S.tangentDim(), 5);
+  BOOST_CHECK_EQUAL(S.representationDim(), 5);
+  BOOST_CHECK_EQUAL(S.numberOfSubmanifolds(), 1);
+  BOOST_CHECK(S.isElementary());
+  BOOST_CHECK_EQUAL(S.name(), "S4");
+
+  Eigen::VectorXd e0 = Eigen::VectorXd::Zero(5);
+  e0[0] = 1;
+  BOOST_CHECK_EQUAL(S.getZero().value(), e0);
+  Point x = S.createRandomPoint();
+  BOOST_CHECK(x.isInM());
+  x.value() *= 1.1;
+  BOOST_CHECK(!x.isInM());
+
+  S2 S2_;
+  BOOST_CHECK_EQUAL(S.getTypeId(), Sn(7).getTypeId());
+  BOOST_CHECK(S.getTypeId() != S2_.getTypeId());
+}
+
+BOOST_AUTO_TEST_CASE(SnMatchesS2)
+{
+  Sn S(2);
+  S2 S2_;
+  for (int i = 0; i < 10; ++i)
+  {
+    Point x = S.createRandomPoint();
+    Eigen::Vector3d v = Eigen::Vector3d::Random();
+    S.forceOnTxM(v, v, x.value());
+    Eigen::Vector3d y, y2, l, l2;
+    S.retractation(y, x.value(), v);
+    S2_.retractation(y2, x.value(), v);
+    BOOST_CHECK(y.isApprox(y2));
+    S.pseudoLog(l, x.value(), y);
+    S2_.pseudoLog(l2, x.value(), y);
+    BOOST_CHECK(l.isApprox(l2));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SnLogarithm)
+{
+  Sn S(7);
+  double angles[] = {1e-6, 1e-3, 0.5, 2., 3.};
+  for (double t : angles)
+  {
+    Point x = S.createRandomPoint();
+    Eigen::VectorXd u = randomUnitTangent(S, x.value());
+    //point at distance t along the geodesic of direction u
+    Eigen::VectorXd y = cos(t)*x.value() + sin(t)*u;
+    Eigen::VectorXd l(8);
+    S.pseudoLog(l, x.value(), y);
+    BOOST_CHECK(l.isApprox(t*u, 1e-9));
+    BOOST_CHECK_CLOSE(S.distance(x.value(), y), t, 1e-7);
+    BOOST_CHECK(S.isInTxM(x.value(), l));
+
+    Eigen::VectorXd l0(8), lz(8);
+    S.pseudoLog0(l0, y);
+    S.pseudoLog(lz, S.getZero().value(), y);
+    BOOST_CHECK(l0.isApprox(lz, 1e-12));
+  }
+
+  //the retractation keeps the points on the sphere, in the direction of v
+  Point x = S.createRandomPoint();
+  Eigen::VectorXd v = 0.3*randomUnitTangent(S, x.value());
+  Point y = x + v;
+  BOOST_CHECK(y.isInM());
+  Eigen::VectorXd l(8);
+  S.pseudoLog(l, x.value(), y.value());
+  BOOST_CHECK(l.normalized().isApprox(v.normalized()));
+  BOOST_CHECK_CLOSE(l.norm(), atan(0.3), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(SnDiff)
+{
+  Sn S(5);
+  const double h = 1e-7;
+  Point x = S.createRandomPoint();
+  //the retractation is differentiated in the ambient space, where the
+  //increments are not tangent
+  Eigen::MatrixXd J(6, 6);
+  Eigen::VectorXd y(6);
+  for (Index i = 0; i < 6; ++i)
+  {
+    Eigen::VectorXd dv = Eigen::VectorXd::Zero(6);
+    dv[i] = h;
+    Sn::retractCols(y, x.value(), dv);
+    J.col(i) = (y - x.value())/h;
+  }
+  BOOST_CHECK(J.isApprox(S.diffRetractation(x.value()), 1e-5));
+
+  //far from the zero, and close to it where the expansions are used
+  Eigen::VectorXd e0 = S.getZero().value();
+  Eigen::VectorXd points[] = {x.value(), e0 + 1e-3*randomUnitTangent(S, e0)};
+  for (const Eigen::VectorXd& p : points)
+  {
+    Eigen::MatrixXd JL(6, 6);
+    Eigen::VectorXd l0(6), l(6);
+    S.pseudoLog0(l0, p);
+    for (Index i = 0; i < 6; ++i)
+    {
+      Eigen::VectorXd pi = p;
+      pi[i] += h;
+      S.pseudoLog0(l, pi);
+      JL.col(i) = (l - l0)/h;
+    }
+    BOOST_CHECK(JL.isApprox(S.diffPseudoLog0(p), 1e-5));
+  }
+
+  Eigen::MatrixXd Jf = Eigen::MatrixXd::Random(4, 6);
+  Eigen::MatrixXd out(4, 6);
+  S.applyDiffRetractation(out, Jf, x.value());
+  BOOST_CHECK(out.isApprox(Jf*S.diffRetractation(x.value())));
+  S.applyDiffPseudoLog0(out, Jf, x.value());
+  BOOST_CHECK(out.isApprox(Jf*S.diffPseudoLog0(x.value())));
+
+  //transported vectors are tangent at x+v
+  Eigen::VectorXd v = 0.5*randomUnitTangent(S, x.value());
+  Eigen::MatrixXd T = Eigen::MatrixXd::Random(6, 3);
+  Eigen::MatrixXd Tout(6, 3);
+  S.applyTransport(Tout, T, x.value(), v);
+  Point z = x + v;
+  BOOST_CHECK((z.value().transpose()*Tout).isZero(1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(SnBatch)
+{
+  Sn S(9);
+  const Index n = 75;
+  PointSet X(S);
+  for (Index j = 0; j < n; ++j)
+    X.push_back(S.createRandomPoint().value());
+  Eigen::MatrixXd v = Eigen::MatrixXd::Random(10, n);
+  Sn::projCols(v, v, X.values());
+  for (Index j = 0; j < n; ++j)
+    BOOST_CHECK(S.isInTxM(X[j].value(), v.col(j)));
+
+  PointSet Y(S);
+  X.retractation(Y, v);
+  for (Index j = 0; j < n; ++j)
+    BOOST_CHECK(Y[j].value().isApprox((Point(X[j]) + v.col(j)).value()));
+
+  Eigen::MatrixXd l(10, n);
+  Sn::logCols(l, X.values(), Y.values());
+  Eigen::VectorXd lj(10);
+  for (Index j = 0; j < n; ++j)
+  {
+    S.pseudoLog(lj, X[j].value(), Y[j].value());
+    BOOST_CHECK(l.col(j).isApprox(lj));
+  }
+
+  PointSet Z(X);
+  Z.setLayout(PointSet::StructureOfArrays);
+  Eigen::MatrixXd vt = v.transpose();
+  Z.increment(vt);
+  BOOST_CHECK(Z.values().isApprox(Y.values().transpose()));
+
+  typedef StaticCartesianProduct<RealSpaceN<2>, SnN<4> > Prod;
+  Prod P;
+  BOOST_CHECK_EQUAL(P.dim(), 6);
+  BOOST_CHECK_EQUAL(P.representationDim(), 7);
+  Point x = P.createRandomPoint();
+  BOOST_CHECK(x.isInM());
+}
+
+#if   EIGEN_WORLD_VERSION > 3 \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(SnNoAllocation)
+{
+  const int r = 100;
+  Sn S(6);
+  Eigen::VectorXd x = S.createRandomPoint().value();
+  Eigen::VectorXd y = S.createRandomPoint().value();
+  Eigen::VectorXd p = Eigen::VectorXd::Random(7);
+  S.forceOnTxM(p, p, x);
+  Eigen::VectorXd z(7);
+  Eigen::VectorXd d(7);
+  Eigen::MatrixXd J0 = Eigen::MatrixXd::Random(r, 7);
+  Eigen::MatrixXd J1(r, 7);
+  Eigen::MatrixXd J2(r, 7);
+  Eigen::MatrixXd H0 = Eigen::MatrixXd::Random(7, 7);
+  Eigen::MatrixXd H1(7, 7);
+  Eigen::MatrixXd X = Eigen::MatrixXd::Random(7, r);
+  Eigen::MatrixXd V = Eigen::MatrixXd::Random(7, r);
+  Eigen::MatrixXd Y(7, r);
+
+  S.applyDiffRetractation(J1, J0, x);
+  S.applyDiffPseudoLog0(J2, J1, x);
+  S.applyTransport(H1, H0, x, p);
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  utils::set_is_malloc_allowed(false);
+  {
+    S.retractation(z, x, p);
+    S.pseudoLog(d, y, x);
+    S.pseudoLog0(d, x);
+    S.applyDiffRetractation(J1, J0, x);
+    S.applyDiffPseudoLog0(J2, J1, x);
+    S.applyTransport(H1, H0, x, p);
+    S.applyInvTransport(H1, H0, x, p);
+    Sn::retractCols(Y, X, V);
+    Sn::logCols(V, X, Y);
+    Sn::projCols(V, V, X);
+  }
+  utils::set_is_malloc_allowed(true);
+  Eigen::internal::set_is_malloc_allowed(true);
+}
+#endif
@@ -0,0 +1,49 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+//This test is built without MNF_ASSERT_THROW, as library users do, so that
+//mnf_assert is the macro version when the headers are instantiated.
+#undef MNF_ASSERT_THROW
+
+#include <manifolds/defs.h>
+#include <manifolds/RealSpace.h>
+#include <manifolds/S2.h>
+#include <manifolds/SO3.h>
+#include <manifolds/ExpMapQuaternion.h>
+#include <manifolds/StaticCartesianProduct.h>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+BOOST_AUTO_TEST_CASE(StaticCartProdWithoutAssertThrow)
+{
+  StaticCartesianProduct<RealSpaceN<3>, S2, SO3<ExpMapQuaternion> > P;
+  BOOST_CHECK_EQUAL(P.dim(), 8);
+  BOOST_CHECK_EQUAL(P.representationDim(), 10);
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  Eigen::VectorXd v0 = Eigen::VectorXd::Random(P.tangentDim());
+  Eigen::VectorXd v(P.tangentDim());
+  P.forceOnTxM(v, v0, x);
+  Eigen::VectorXd y(P.representationDim());
+  P.retractation(y, x, v);
+  BOOST_CHECK(P.isInM(y));
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+#define _USE_MATH_DEFINES
+#include <math.h>
+
+#include <manifolds/defs.h>
+#include <manifolds/utils.h>
+#include <manifolds/S2.h>
+#include <manifolds/SO3.h>
+#include <manifolds/RealSpace.h>
+#include <manifolds/CartesianProduct.h>
+#include <manifolds/StaticCartesianProduct.h>
+#include <manifolds/Point.h>
+#include <manifolds/ExpMapMatrix.h>
+#include <manifolds/ExpMapQuaternion.h>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+typedef StaticCartesianProduct<RealSpaceN<3>, SO3<ExpMapQuaternion>, RealSpaceN<2>, SO3<ExpMapMatrix> > StaticProd;
+typedef StaticCartesianProduct<RealSpaceN<3>, S2, SO3<ExpMapQuaternion> > StaticProdS2;
+
+BOOST_AUTO_TEST_CASE(StaticCartProdConstructor)
+{
+  StaticProd P;
+  BOOST_CHECK_EQUAL(P.dim(), 11);
+  BOOST_CHECK_EQUAL(P.tangentDim(), 11);
+  BOOST_CHECK_EQUAL(P.representationDim(), 18);
+  BOOST_CHECK_EQUAL(P.numberOfSubmanifolds(), 4);
+  BOOST_CHECK(P.name().compare("R3xSO3xR2xSO3") == 0);
+  BOOST_CHECK(!P.isElementary());
+  BOOST_CHECK_EQUAL(P(2).name(), "R2");
+  BOOST_CHECK_EQUAL(StaticProd::RepresentationDim_, 18);
+
+  StaticProdS2 Q;
+  BOOST_CHECK_EQUAL(Q.dim(), 8);
+  BOOST_CHECK_EQUAL(Q.tangentDim(), 9);
+  BOOST_CHECK_EQUAL(Q.representationDim(), 10);
+  BOOST_CHECK(Q.name().compare("R3xS2xSO3") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(StaticCartProdMatchesDynamic)
+{
+  StaticProd P;
+  P.leaf<0>().setTypicalMagnitude(2.0);
+  RealSpace R3(3, 2.0);
+  SO3<ExpMapQuaternion> RotQ;
+  RealSpace R2(2);
+  SO3<ExpMapMatrix> RotM;
+  CartesianProduct Q(R3, RotQ);
+  Q.multiply(R2);
+  Q.multiply(RotM);
+
+  BOOST_CHECK_EQUAL(P.getTypicalMagnitude(), Q.getTypicalMagnitude());
+
+  Eigen::VectorXd x = Q.createRandomPoint().value();
+  Eigen::VectorXd y = Q.createRandomPoint().value();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(11);
+  BOOST_CHECK(P.isInM(x));
+
+  Eigen::VectorXd zs(18), zd(18);
+  P.setZero(zs);
+  Q.setZero(zd);
+  BOOST_CHECK_EQUAL(zs, zd);
+
+  Eigen::VectorXd rs(18), rd(18);
+  P.retractation(rs, x, v);
+  Q.retractation(rd, x, v);
+  BOOST_CHECK(rs.isApprox(rd, 1e-12));
+
+  Eigen::VectorXd ls(11), ld(11);
+  P.pseudoLog(ls, x, y);
+  Q.pseudoLog(ld, x, y);
+  BOOST_CHECK(ls.isApprox(ld, 1e-12));
+  P.pseudoLog0(ls, x);
+  Q.pseudoLog0(ld, x);
+  BOOST_CHECK(ls.isApprox(ld, 1e-12));
+
+  BOOST_CHECK(P.diffRetractation(x).isApprox(Q.diffRetractation(x), 1e-12));
+  BOOST_CHECK(P.diffPseudoLog0(x).isApprox(Q.diffPseudoLog0(x), 1e-12));
+  BlockDiagonalMatrix J = P.diffRetractationBlocks(x);
+  BOOST_CHECK_EQUAL(J.numberOfBlocks(), 4);
+  BOOST_CHECK(J.toDense().isApprox(Q.diffRetractation(x), 1e-12));
+
+  Eigen::MatrixXd inR = Eigen::MatrixXd::Random(5, 18);
+  Eigen::MatrixXd outS(5, 11), outD(5, 11);
+  P.applyDiffRetractation(outS, inR, x);
+  Q.applyDiffRetractation(outD, inR, x);
+  BOOST_CHECK(outS.isApprox(outD, 1e-12));
+
+  Eigen::MatrixXd inT = Eigen::MatrixXd::Random(5, 11);
+  Eigen::MatrixXd out2S(5, 18), out2D(5, 18);
+  P.applyDiffPseudoLog0(out2S, inT, x);
+  Q.applyDiffPseudoLog0(out2D, inT, x);
+  BOOST_CHECK(out2S.isApprox(out2D, 1e-12));
+
+  Eigen::VectorXd ms(11), md(11);
+  P.limitMap(ms);
+  Q.limitMap(md);
+  BOOST_CHECK_EQUAL(ms, md);
+}
+
+BOOST_AUTO_TEST_CASE(StaticCartProdS2MatchesDynamic)
+{
+  StaticProdS2 P;
+  RealSpace R3(3);
+  S2 Sphere;
+  SO3<ExpMapQuaternion> RotQ;
+  CartesianProduct Q(R3, Sphere);
+  Q.multiply(RotQ);
+
+  Eigen::VectorXd x = Q.createRandomPoint().value();
+  Eigen::VectorXd y = Q.createRandomPoint().value();
+  Eigen::VectorXd v = Eigen::VectorXd::Random(9);
+  Q.forceOnTxM(v, v, x);
+  BOOST_CHECK(P.isInM(x));
+  BOOST_CHECK(P.isInTxM(x, v));
+
+  Eigen::VectorXd rs(10), rd(10);
+  P.retractation(rs, x, v);
+  Q.retractation(rd, x, v);
+  BOOST_CHECK(rs.isApprox(rd, 1e-12));
+
+  Eigen::VectorXd ls(9), ld(9);
+  P.pseudoLog(ls, x, y);
+  Q.pseudoLog(ld, x, y);
+  BOOST_CHECK(ls.isApprox(ld, 1e-12));
+
+  Eigen::MatrixXd Cs(1, 9), Cd(1, 9);
+  P.tangentConstraint(Cs, x);
+  Q.tangentConstraint(Cd, x);
+  BOOST_CHECK(Cs.isApprox(Cd, 1e-12));
+
+  Eigen::MatrixXd X(10, 4), V(9, 4), Os(10, 4), Od(10, 4);
+  for (Index j = 0; j < 4; ++j)
+  {
+    X.col(j) = Q.createRandomPoint().value();
+    V.col(j) = Eigen::VectorXd::Random(9);
+    Q.forceOnTxM(V.col(j), V.col(j), X.col(j));
+  }
+  P.batchRetractation(Os, X, V);
+  Q.batchRetractation(Od, X, V);
+  BOOST_CHECK(Os.isApprox(Od, 1e-12));
+}
+
+BOOST_AUTO_TEST_CASE(StaticCartProdViews)
+{
+  StaticProd P;
+  Point x = P.createRandomPoint();
+  BOOST_CHECK(P.isInM(x.value()));
+  BOOST_CHECK(x(1).value() == x.value().segment<4>(3));
+  BOOST_CHECK(x(3).value() == x.value().segment<9>(9));
+  BOOST_CHECK_EQUAL(x(2).getManifold().name(), "R2");
+}
+
+#if EIGEN_WORLD_VERSION > 3 || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(StaticCartProdNoAllocation)
+{
+  StaticProd P;
+  Eigen::VectorXd x = P.createRandomPoint().value();
+  Eigen::VectorXd v = 0.1*Eigen::VectorXd::Random(11);
+  Eigen::VectorXd z(18);
+  Eigen::MatrixXd inR = Eigen::MatrixXd::Random(5, 18);
+  Eigen::MatrixXd outT(5, 11);
+
+  Eigen::internal::set_is_malloc_allowed(false);
+  {
+    P.retractation(z, x, v);
+    P.pseudoLog0(v, z);
+    P.applyDiffRetractation(outT, inR, x);
+    BOOST_CHECK(P.isInM(z));
+  }
+  Eigen::internal::set_is_malloc_allowed(true);
+}
+#endif
@@ -0,0 +1,317 @@
+// Copyright (c) 2015 CNRS
+// Authors: Stanislas Brossette, Adrien Escande 
+
+// This file is part of manifolds
+// manifolds is free software: you can redistribute it
+// and/or modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation, either version
+// 3 of the License, or (at your option) any later version.
+
+// manifolds is distributed in the hope that it will be
+// useful, but WITHOUT ANY WARRANTY; without even the implied warranty
+// of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Lesser Public License for more details.  You should have
+// received a copy of the GNU Lesser General Public License along with
+// manifolds. If not, see
+// <http://www.gnu.org/licenses/>.
+
+#include <iostream>
+
+#include <manifolds/defs.h>
+#include <manifolds/utils.h>
+#include <manifolds/mnf_assert.h>
+#include <manifolds/Point.h>
+#include <manifolds/PointSet.h>
+#include <manifolds/Sn.h>
+#include <manifolds/Stiefel.h>
+
+#include <Eigen/LU>
+#include <Eigen/QR>
+
+#ifndef _WIN32
+#define BOOST_TEST_MODULE Manifolds 
+#endif
+
+#include <boost/test/unit_test.hpp>
+
+using namespace mnf;
+
+namespace
+{
+  Eigen::VectorXd randomTangent(const Manifold& M, const ConstRefVec& x, double scale)
+  {
+    Eigen::VectorXd v = scale*Eigen::VectorXd::Random(M.tangentDim());
+    M.forceOnTxM(v, v, x);
+    return v;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StiefelConstructor)
+{
+  Stiefel St(5, 3);
+  BOOST_CHECK_EQUAL(St.dim(), 9);
+  BOOST_CHECK_EQUAL(St.tangentDim(), 15);
+  BOOST_CHECK_EQUAL(St.representationDim(), 15);
+  BOOST_CHECK_EQUAL(St.ambientDim(), 5);
+  BOOST_CHECK_EQUAL(St.frameSize(), 3);
+  BOOST_CHECK_EQUAL(St.retractationType(), Stiefel::QR);
+  BOOST_CHECK_EQUAL(Stiefel(5, 3, Stiefel::Cayley).retractationType(), Stiefel::Cayley);
+  BOOST_CHECK(St.isElementary());
+
+  Eigen::MatrixXd zero = Eigen::MatrixXd::Identity(5, 3);
+  BOOST_CHECK_EQUAL(St.getZero().value(), Eigen::Map<Eigen::VectorXd>(zero.data(), 15));
+  Point x = St.createRandomPoint();
+  BOOST_CHECK(x.isInM());
+  Eigen::Map<const Eigen::MatrixXd> X(x.value().data(), 5, 3);
+  BOOST_CHECK((X.transpose()*X).isIdentity(1e-12));
+  x.value()[14] += 0.1;
+  BOOST_CHECK(!x.isInM());
+  BOOST_CHECK_EQUAL(St.getTypeId(), Stiefel(4, 2).getTypeId());
+  BOOST_CHECK(St.getTypeId() != Sn(2).getTypeId());
+
+  //St(n, 1) is the sphere
+  Stiefel S1(4, 1);
+  BOOST_CHECK_EQUAL(S1.dim(), Sn(3).dim());
+}
+
+BOOST_AUTO_TEST_CASE(StiefelQRRetractation)
+{
+  const Index n = 6, p = 3;
+  Stiefel St(n, p);
+  Eigen::VectorXd x = St.createRandomPoint().value();
+  Eigen::VectorXd v = randomTangent(St, x, 0.5);
+  BOOST_CHECK(St.isInTxM(x, v));
+
+  Eigen::VectorXd y(n*p);
+  St.retractation(y, x, v);
+  BOOST_CHECK(St.isInM(y));
+
+  //y is the Q factor of x+v with a positive diagonal in R
+  Eigen::MatrixXd A = Eigen::Map<Eigen::MatrixXd>(x.data(), n, p) + Eigen::Map<Eigen::MatrixXd>(v.data(), n, p);
+  Eigen::HouseholderQR<Eigen::MatrixXd> qr(A);
+  Eigen::MatrixXd Q = qr.householderQ()*Eigen::MatrixXd::Identity(n, p);
+  for (Index j = 0; j < p; ++j)
+  {
+    if (qr.matrixQR()(j, j) < 0)
+      Q.col(j) *= -1;
+  }
+  BOOST_CHECK(Eigen::Map<Eigen::MatrixXd>(y.data(), n, p).isApprox(Q, 1e-12));
+
+  //pseudoLog is the inverse of the retractation
+  Eigen::VectorXd l(n*p);
+  St.pseudoLog(l, x, y);
+  BOOST_CHECK(St.isInTxM(x, l));
+  BOOST_CHECK(l.isApprox(v, 1e-10));
+
+  //pseudoLog0 around the zero
+  Eigen::VectorXd e = St.getZero().value();
+  Eigen::VectorXd w = randomTangent(St, e, 0.5);
+  Eigen::VectorXd z(n*p);
+  St.retractation(z, e, w);
+  St.pseudoLog0(l, z);
+  BOOST_CHECK(l.isApprox(w, 1e-10));
+
+  //aliasing
+  z = x;
+  St.retractation(z, z, v);
+  BOOST_CHECK(z.isApprox(y));
+}
+
+BOOST_AUTO_TEST_CASE(StiefelCayleyRetractation)
+{
+  const Index n = 7, p = 3;
+  Stiefel St(n, p, Stiefel::Cayley);
+  Eigen::VectorXd x = St.createRandomPoint().value();
+  Eigen::VectorXd v = randomTangent(St, x, 0.8);
+  Eigen::VectorXd y(n*p);
+  St.retractation(y, x, v);
+  BOOST_CHECK(St.isInM(y, 1e-12));
+
+  //dense formula (I-W/2)^{-1} (I+W/2) X
+  Eigen::Map<Eigen::MatrixXd> X(x.data(), n, p);
+  Eigen::Map<Eigen::MatrixXd> V(v.data(), n, p);
+  Eigen::MatrixXd P = Eigen::MatrixXd::Identity(n, n) - 0.5*X*X.transpose();
+  Eigen::MatrixXd W = P*V*X.transpose() - X*V.transpose()*P;
+  Eigen::MatrixXd I = Eigen::MatrixXd::Identity(n, n);
+  Eigen::MatrixXd Y = (I - 0.5*W).lu().solve((I + 0.5*W)*X);
+  BOOST_CHECK(Eigen::Map<Eigen::MatrixXd>(y.data(), n, p).isApprox(Y, 1e-12));
+
+  //both retractations agree at first order
+  Stiefel Sq(n, p);
+  const double h = 1e-4;
+  Eigen::VectorXd yq(n*p);
+  St.retractation(y, x, h*v);
+  Sq.retractation(yq, x, h*v);
+  BOOST_CHECK((y - x).isApprox(h*v, 1e-3));
+  BOOST_CHECK((y - yq).norm() < 10*h*h);
+
+  //pseudoLog inverts the retractation up to second order
+  Eigen::VectorXd l(n*p);
+  St.pseudoLog(l, x, y);
+  BOOST_CHECK((l - h*v).norm() < 10*h*h);
+}
+
+BOOST_AUTO_TEST_CASE(StiefelDiff)
+{
+  const Index n = 5, p = 3;
+  const Index r = n*p;
+  const double h = 1e-6;
+  Stiefel::Retractation types[] = {Stiefel::QR, Stiefel::Cayley};
+  for (int t = 0; t < 2; ++t)
+  {
+    Stiefel St(n, p, types[t]);
+    Eigen::VectorXd x = St.createRandomPoint().value();
+
+    //on the tangent space, the differential of the retractation is the identity
+    Eigen::MatrixXd J = St.diffRetractation(x);
+    Eigen::VectorXd v = randomTangent(St, x, 1);
+    BOOST_CHECK((J*v).isApprox(v, 1e-12));
+    Eigen::VectorXd y(r);
+    St.retractation(y, x, h*v);
+    BOOST_CHECK(((y - x)/h).isApprox(J*v, 1e-5));
+
+    //the differential off the tangent space, against a dense evaluation
+    Eigen::Map<Eigen::MatrixXd> X(x.data(), n, p);
+    Eigen::MatrixXd Jd(r, r);
+    for (Index i = 0; i < r; ++i)
+    {
+      Eigen::MatrixXd E = Eigen::MatrixXd::Zero(n, p);
+      E.data()[i] = 1;
+      Eigen::MatrixXd A = X.transpose()*E;
+      Eigen::MatrixXd D;
+      if (types[t] == Stiefel::QR)
+      {
+        Eigen::MatrixXd L = A.triangularView<Eigen::StrictlyLower>();
+        D = E - X*A + X*(L - L.transpose());
+      }
+      else
+        D = E - 0.5*X*A - 0.5*X*E.transpose()*X;
+      Jd.col(i) = Eigen::Map<Eigen::VectorXd>(D.data(), r);
+    }
+    BOOST_CHECK(J.isApprox(Jd, 1e-12));
+
+    Eigen::MatrixXd G = Eigen::MatrixXd::Random(4, r);
+    Eigen::MatrixXd out(4, r);
+    St.applyDiffRetractation(out, G, x);
+    BOOST_CHECK(out.isApprox(G*J));
+
+    //diffPseudoLog0 by finite differences in the ambient space, around a
+    //point where pseudoLog0 is well conditioned
+    Eigen::VectorXd e = St.getZero().value();
+    Eigen::VectorXd x0(r);
+    St.retractation(x0, e, randomTangent(St, e, 0.5));
+    Eigen::MatrixXd J0 = St.diffPseudoLog0(x0);
+    Eigen::MatrixXd Jfd(r, r);
+    Eigen::VectorXd l0(r), l1(r);
+    St.pseudoLog0(l0, x0);
+    for (Index i = 0; i < r; ++i)
+    {
+      Eigen::VectorXd xi = x0;
+      xi[i] += h;
+      St.pseudoLog0(l1, xi);
+      Jfd.col(i) = (l1 - l0)/h;
+    }
+    BOOST_CHECK(J0.isApprox(Jfd, 1e-5));
+    St.applyDiffPseudoLog0(out, G, x0);
+    BOOST_CHECK(out.isApprox(G*J0));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(StiefelTransport)
+{
+  const Index n = 6, p = 2;
+  Stiefel St(n, p, Stiefel::Cayley);
+  Eigen::VectorXd x = St.createRandomPoint().value();
+  Eigen::VectorXd v = randomTangent(St, x, 0.5);
+  Eigen::VectorXd y(n*p);
+  St.retractation(y, x, v);
+
+  Eigen::MatrixXd H(n*p, 3);
+  for (Index j = 0; j < 3; ++j)
+    H.col(j) = randomTangent(St, x, 1);
+  Eigen::MatrixXd T(n*p, 3);
+  St.applyTransport(T, H, x, v);
+  for (Index j = 0; j < 3; ++j)
+    BOOST_CHECK(St.isInTxM(y, T.col(j), 1e-12));
+  Eigen::MatrixXd T2 = H;
+  St.applyTransport(T2, T2, x, v);
+  BOOST_CHECK(T2.isApprox(T));
+
+  Eigen::MatrixXd G = Eigen::MatrixXd::Random(4, n*p);
+  Eigen::MatrixXd Gt(4, n*p);
+  St.applyInvTransport(Gt, G, x, v);
+  for (Index i = 0; i < 4; ++i)
+    BOOST_CHECK(St.isInTxM(x, Gt.row(i).transpose(), 1e-12));
+
+  Eigen::MatrixXd C(St.tangentDim() - St.dim(), n*p);
+  St.tangentConstraint(C, x);
+  BOOST_CHECK((C*v).isZero(1e-12));
+  BOOST_CHECK(!(C*Eigen::VectorXd::Random(n*p)).isZero(1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(StiefelBatch)
+{
+  Stiefel St(5, 2, Stiefel::Cayley);
+  const Index N = 10;
+  PointSet X(St);
+  Eigen::MatrixXd v(10, N);
+  for (Index j = 0; j < N; ++j)
+  {
+    X.push_back(St.createRandomPoint().value());
+    v.col(j) = randomTangent(St, X[j].value(), 1);
+  }
+
+  PointSet Y(St);
+  X.retractation(Y, v);
+  for (Index j = 0; j < N; ++j)
+    BOOST_CHECK(Y[j].value().isApprox((Point(X[j]) + v.col(j)).value()));
+
+  PointSet S(X);
+  S.setLayout(PointSet::StructureOfArrays);
+  Eigen::MatrixXd vt = v.transpose();
+  S.increment(vt);
+  BOOST_CHECK(S.values().isApprox(Y.values().transpose()));
+}
+
+#if   EIGEN_WORLD_VERSION > 3 \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION > 2) \
+  || (EIGEN_WORLD_VERSION == 3 && EIGEN_MAJOR_VERSION == 2 && EIGEN_MINOR_VERSION > 0)
+BOOST_AUTO_TEST_CASE(StiefelNoAllocation)
+{
+  const int r = 20;
+  Stiefel::Retractation types[] = {Stiefel::QR, Stiefel::Cayley};
+  for (int k = 0; k < 2; ++k)
+  {
+    Stiefel St(8, 3, types[k]);
+    Index t = St.tangentDim();
+    Eigen::VectorXd x = St.createRandomPoint().value();
+    Eigen::VectorXd p = randomTangent(St, x, 0.3);
+    Eigen::VectorXd y(t);
+    St.retractation(y, x, p);
+    Eigen::VectorXd z(t);
+    Eigen::VectorXd d(t);
+    Eigen::MatrixXd J0 = Eigen::MatrixXd::Random(r, t);
+    Eigen::MatrixXd J1(r, t);
+    Eigen::MatrixXd J2(r, t);
+    Eigen::MatrixXd H0 = Eigen::MatrixXd::Random(t, 5);
+    Eigen::MatrixXd H1(t, 5);
+
+    St.applyDiffPseudoLog0(J2, J1, x);
+
+    Eigen::internal::set_is_malloc_allowed(false);
+    utils::set_is_malloc_allowed(false);
+    {
+      St.retractation(z, x, p);
+      St.pseudoLog(d, x, y);
+      St.pseudoLog0(d, x);
+      St.forceOnTxM(d, d, x);
+      St.applyDiffRetractation(J1, J0, x);
+      St.applyDiffPseudoLog0(J2, J1, x);
+      St.applyTransport(H1, H0, x, p);
+      St.applyInvTransport(J1, J0, x, p);
+    }
+    utils::set_is_malloc_allowed(true);
+    Eigen::internal::set_is_malloc_allowed(true);
+  }
+}
+#endif